@@ -9,7 +9,6 @@
 #include "HighPassControl.h"
 #include "PeakFilterControl.h"
 #include "LowPassControl.h"
-#include "Linkable.h"
 #include "Icon.h"
 #include "EqVisual.h"
 #include "CtmLookAndFeel.h"
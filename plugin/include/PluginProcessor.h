@@ -1,5 +1,9 @@
 #pragma once
+#include <array>
+#include <atomic>
 #include <list>
+#include <type_traits>
+#include <vector>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 #include <juce_data_structures/juce_data_structures.h>
@@ -9,6 +13,13 @@
 #include "PeakFilter.h"
 #include "LowPassFilter.h"
 #include "GainFilter.h"
+#include "SmootherBank.h"
+#include "ProcessHeartbeat.h"
+#include "AutomationQueue.h"
+#include "BinaryState.h"
+#include "GestureCounter.h"
+#include "BiquadCascade.h"
+#include "DualBiquadCascade.h"
 
 namespace dsp = juce::dsp;
 
@@ -16,6 +27,9 @@ class PluginProcessor final : public juce::AudioProcessor
 {
 public:
     // === Public Variables ===================================================
+    // every value the filters ramp. it is made before the filters, which
+    // take their lanes from it as they are made
+    SmootherBank smoothers;
     GainFilter gainOne;
     GainFilter gainTwo;
     HighPassFilter highPassOne;
@@ -41,7 +55,12 @@ public:
         { return "Split EQ"; }
 
     inline bool hasEditor() const override { return true; }
-    inline double getTailLengthSeconds() const override { return 0.0; }
+    inline bool supportsDoublePrecisionProcessing() const override
+        { return true; }
+    // how long the slowest pole of the current settings rings for, which is
+    // infinite if one ever sits on the unit circle
+    inline double getTailLengthSeconds() const override
+        { return tailSeconds.load(); }
     
     inline int getNumPrograms() override { return 1; } // should always be >= 1
     inline int getCurrentProgram() override { return 0; }
@@ -80,21 +99,118 @@ public:
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-    using AudioProcessor::processBlock;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    void setCoefficientUpdateInterval(int numSamples);
+    // whether the host has delivered audio within the last couple of
+    // blocks. message thread only; the audio thread decides for itself
+    // from the blocks it has run, so a render never depends on timing
+    inline bool isProcessingAudio() const { return heartbeat.isAlive(); }
+    // runs the filters in double precision even when float buffers are
+    // handed over. takes effect the next time prepareToPlay is called. hosts
+    // with 64 bit busses get double precision through the double overload;
+    // this is for callers that only have float audio, like the batch
+    // renderer's --double-state option
+    void setDoublePrecisionState(bool);
+    // applies the change on the given sample, counted from prepareToPlay,
+    // rather than at the start of the block it falls in. changes must be
+    // scheduled in order from a single thread. false if the queue is full
+    bool scheduleParameterChange
+    (juce::AudioProcessorParameter*, float normalisedValue,
+    juce::int64 position);
+
+    // === Transactions =======================================================
+    // collects writes to many parameters into one undoable step. the
+    // parameters that actually change are announced to the host together,
+    // as a single gesture, and the filters and display pick them all up on
+    // their next poll. message thread only
+    void beginTransaction(const juce::String& name);
+    void setInTransaction(juce::RangedAudioParameter*, float normalisedValue);
+    void endTransaction();
+
+    // === Linking ============================================================
+    // the follower of each pair reads the leader's values while the link
+    // parameter is on. the links are made here rather than by the editor,
+    // so they hold with the editor closed and in headless renders
+    struct FilterLink
+    {
+        const char* id;
+        CtmFilter* leader;
+        CtmFilter* follower;
+    };
+    inline const std::array<FilterLink, 6>& getFilterLinks() const
+        { return filterLinks; }
+    inline const GestureCounter& getGestureCounter() const
+        { return gestureCounter; }
 
     // === State ==============================================================
     bool isMidSide();
     void resetAllParams();
+    void setAllLinked(bool);
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
+    // reads both the binary state and the xml saved by earlier versions,
+    // and is false if the data is neither
+    bool restoreState(const void* data, int sizeInBytes);
     void notifyHostOfStateChange();
 
     // === Factory Functions ==================================================
     juce::AudioProcessorEditor* createEditor() override;
 
 private:
+    // everything the channel chains need at one sample precision
+    template <typename SampleType>
+    struct ChannelState
+    {
+        BiquadCascade<SampleType> cascadeOne;
+        BiquadCascade<SampleType> cascadeTwo;
+        DualBiquadCascade<SampleType> dualCascade;
+        std::array<SampleType, 512> matrixBuffer;
+    };
+    // the filters of one channel in processing order, and the ones among
+    // them that are not bypassed. the active list is only rebuilt after a
+    // filter's on/off, order or shelf mode changes, or while a bypass fade
+    // runs, so bypassed filters cost nothing per block
+    struct ChannelStages
+    {
+        std::array<CtmFilter*, 5> filters;
+        std::array<CtmFilter*, 5> active;
+        size_t numActive;
+        bool fading;
+    };
+
     double lastSampleRate;
+    int lastBlockSize;
+    ProcessHeartbeat heartbeat;
+    // set by the first block after prepareToPlay. changes are smoothed only
+    // once it is, so the same input and automation always render the same
+    bool processedSincePrepare;
+    AutomationQueue automation;
+    juce::int64 samplePosition;
+    // once the input has been silent for longer than the tail, the filters
+    // have nothing left to ring and processing sleeps until sound returns.
+    // both are infinite until the filters are first designed, so nothing
+    // is cut short before then
+    std::atomic<double> tailSeconds;
+    double tailSamples;
+    juce::int64 silentSamples;
+    // false while any active stage is smoothing, ramping or fading, when
+    // its tail is still changing
+    bool stagesSteady;
+    BinaryState binaryState;
+    ChannelState<float> floatState;
+    ChannelState<double> doubleState;
+    ChannelStages stagesOne;
+    ChannelStages stagesTwo;
+    juce::AudioBuffer<double> doubleBuffer;
+    bool useDoubleState;
+    bool doubleStateActive;
+    std::atomic<float>* modeParameter;
+    bool midSideActive;
+    int modeFadeSamples;
     std::list<ParameterListener*> paramListeners;
+    std::vector<std::pair<juce::RangedAudioParameter*, float>> transaction;
+    std::array<FilterLink, 6> filterLinks;
+    GestureCounter gestureCounter;
 #if PERFETTO
     std::unique_ptr<perfetto::TracingSession> tracingSession;
 #endif
@@ -112,13 +228,47 @@ private:
         { juce::NormalisableRange<float>(0.5, 10, 0.01f, 0.7f) };
     inline static const juce::NormalisableRange<float> qRange
         { juce::NormalisableRange<float>(0.25, 10, 0.01f, 0.7f) };
+    inline static const int modeFadeLength { 200 };
+    // the tail ends when the ringing has fallen to the level biquad state
+    // snaps to zero at
+    inline static const double tailDecayLevel { 1.0e-8 };
 
     // === Other Helper Functions =============================================
-    float processSampleChannelOne(float sample);
-    float processSampleChannelTwo(float sample);
+    void applyPendingParameters(bool smooth);
+    void updateChannelMode(bool wasProcessing);
+    bool applyDueAutomation(juce::int64 position, bool smooth);
+    template <typename SampleType>
+    void processBuffer(juce::AudioBuffer<SampleType>&);
+    template <typename SampleType>
+    void processSegment(SampleType* left, SampleType* right, size_t);
+    template <typename SampleType>
+    void processChannels(SampleType* left, SampleType* right, size_t);
+    template <typename SampleType>
+    void encodeMidSide(SampleType* left, SampleType* right, size_t);
+    template <typename SampleType>
+    void decodeMidSide(SampleType* left, SampleType* right, size_t);
+    template <typename SampleType>
+    void applyModeFade(SampleType* left, SampleType* right, size_t);
+    void advanceSmoothers(size_t numSamples);
+    void updateStages();
+    void updateActiveStages(ChannelStages&);
+    void updateTail();
+    template <typename SampleType>
+    static bool isSilent(const SampleType* data, size_t numSamples);
+    template <typename SampleType>
+    bool gatherCascade(const ChannelStages&, BiquadCascade<SampleType>&);
+    template <typename SampleType>
+    void processStages(const ChannelStages&, SampleType* data, size_t);
+    template <typename SampleType>
+    inline ChannelState<SampleType>& getChannelState()
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+            return floatState;
+        else
+            return doubleState;
+    }
     void resetFilterParams(CtmFilter*);
     void addParameterListener(ParameterListener*);
-    float clampWithinOne(float);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginProcessor)
 };
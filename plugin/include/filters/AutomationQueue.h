@@ -0,0 +1,39 @@
+#pragma once
+#include <array>
+#include <juce_audio_processors/juce_audio_processors.h>
+
+// parameter changes stamped with the sample they take effect on, handed from
+// one scheduling thread to the audio thread without locks. positions count
+// the samples processed since prepareToPlay, and must not decrease from one
+// change to the next. a change that is already due when it arrives is
+// applied at the start of the next block
+class AutomationQueue
+{
+public:
+    struct Change
+    {
+        juce::int64 samplePosition;
+        juce::AudioProcessorParameter* parameter;
+        float normalisedValue;
+    };
+
+    // === Lifecycle ==========================================================
+    AutomationQueue();
+
+    // === Scheduling Thread ==================================================
+    // false if the queue is full, in which case the change is dropped
+    bool push(const Change&);
+
+    // === Audio Thread =======================================================
+    // the position of the earliest pending change, if there is one
+    bool getNextPosition(juce::int64& position) const;
+    // removes the earliest pending change if it is due at or before position
+    bool popDue(juce::int64 position, Change& change);
+    void clear();
+
+private:
+    inline static const int capacity { 1024 };
+
+    juce::AbstractFifo fifo;
+    std::array<Change, capacity> changes;
+};
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+#include <optional>
+#include <vector>
+#include <juce_audio_processors/juce_audio_processors.h>
+
+// every parameter's value tagged with a hash of its id, stamped with a
+// version and a checksum. a fraction of the size of the tree's xml and far
+// quicker to write and read back, which matters for autosaves and for
+// sessions with many instances. values are matched to parameters by id, so
+// state still loads after parameters are added, removed or reordered.
+// states saved as xml by earlier versions are still read by the processor
+class BinaryState
+{
+public:
+    // === Lifecycle ==========================================================
+    explicit BinaryState(juce::AudioProcessor&);
+
+    // === Any Thread =========================================================
+    void write(juce::MemoryBlock&) const;
+    static bool isBinaryState(const void* data, size_t size);
+
+    // === Message Thread =====================================================
+    // sets the parameters, then notifies the listeners of each one that
+    // changed. parameters the data holds no value for go back to their
+    // defaults, and values for parameters that no longer exist are skipped.
+    // older versions are migrated. false without changing anything if the
+    // data is corrupt or from a newer version
+    bool read(const void* data, size_t size) const;
+
+private:
+    using Values = std::vector<std::optional<float>>;
+    // the hash of a parameter's id and its index in publish order
+    struct IdEntry
+    {
+        juce::uint32 id;
+        size_t index;
+    };
+
+    std::vector<juce::RangedAudioParameter*> parameters;
+    std::vector<juce::uint32> ids;
+    // sorted by id hash, to look values up by
+    std::vector<IdEntry> byId;
+    // a fingerprint of every id in publish order, which is all version 1
+    // kept to identify its values by
+    juce::uint32 layout;
+
+    // === Static Constants ===================================================
+    // "SPEQ" when read as text
+    inline static const juce::uint32 magic { 0x51455053 };
+    inline static const juce::uint16 version { 2 };
+    // magic, version and value count, then an id hash and a float for each
+    // value, then the checksum
+    inline static const size_t headerSize { 8 };
+    inline static const size_t entrySize { 8 };
+    inline static const size_t checksumSize { 4 };
+    // version 1 followed the count with the layout fingerprint, then held
+    // only the values, in publish order
+    inline static const size_t layoutSize { 4 };
+    inline static const juce::uint32 hashSeed { 2166136261u };
+    inline static const juce::uint32 hashPrime { 16777619u };
+
+    // === Private Helper =====================================================
+    bool readVersionOne
+    (juce::MemoryInputStream&, size_t count, size_t size, Values&) const;
+    bool readVersionTwo
+    (juce::MemoryInputStream&, size_t count, size_t size, Values&) const;
+    static juce::uint32 hash(juce::uint32 seed, const void* data, size_t size);
+};
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+#include <cstddef>
+
+// coefficients of a biquad normalised so that a0 is always 1, designed with
+// the RBJ cookbook formulas used by juce::dsp::IIR::Coefficients. designs are
+// kept in double precision and rounded to the precision of each section when
+// they are applied. being a plain value type, these can be designed and
+// assigned on the audio thread without allocating or touching any reference
+// counts
+typedef struct BiquadCoefficients
+{
+    // === Fields =============================================================
+    double b0;
+    double b1;
+    double b2;
+    double a1;
+    double a2;
+
+    // === Factory Functions ==================================================
+    static BiquadCoefficients makeIdentity();
+    static BiquadCoefficients makeHighPass
+    (double sampleRate, float frequency, float q);
+    static BiquadCoefficients makeLowPass
+    (double sampleRate, float frequency, float q);
+    static BiquadCoefficients makeFirstOrderHighPass
+    (double sampleRate, float frequency);
+    static BiquadCoefficients makeFirstOrderLowPass
+    (double sampleRate, float frequency);
+    static BiquadCoefficients makeLowShelf
+    (double sampleRate, float frequency, float q, float gain);
+    static BiquadCoefficients makeHighShelf
+    (double sampleRate, float frequency, float q, float gain);
+    static BiquadCoefficients makePeakFilter
+    (double sampleRate, float frequency, float q, float gain);
+
+    // === Frequency Response =================================================
+    double getMagnitudeForFrequency(double frequency, double sampleRate) const;
+    void getMagnitudeForFrequencyArray
+    (const double* frequencies, double* magnitudes, size_t, double sampleRate)
+    const;
+
+}
+BiquadCoefficients;
+
+template <typename SampleType> class BiquadCascade;
+template <typename SampleType> class DualBiquadCascade;
+
+// a single biquad section in transposed direct form II, with coefficients and
+// state held at SampleType precision. coefficient changes can be spread over
+// a number of samples, in which case the coefficients are linearly
+// interpolated towards the new design one step per sample
+template <typename SampleType>
+class Biquad
+{
+public:
+    // === Lifecycle ==========================================================
+    Biquad();
+
+    // === Coefficients =======================================================
+    void setCoefficients(const BiquadCoefficients&, int rampLength = 0);
+    inline bool isRamping() const { return rampRemaining > 0; }
+    // true when the section passes its input through untouched, with
+    // coefficients that cancel out and state that has decayed to zero
+    bool isIdentity() const;
+    // the radius of the section's slowest decaying pole, which its ringing
+    // falls by every sample, or of its ramp target if that is slower. taken
+    // from the coefficients alone, so it holds still while the state decays
+    double getPoleRadius() const;
+
+    // === Process Audio ======================================================
+    void reset();
+    inline SampleType processSample(SampleType sample)
+    {
+        if (rampRemaining > 0)
+            advanceRamp();
+        SampleType output = (sample * coefficients.b0) + state1;
+        state1 = (sample * coefficients.b1) - (output * coefficients.a1)
+            + state2;
+        state2 = (sample * coefficients.b2) - (output * coefficients.a2);
+        return output;
+    }
+    void processBlock(SampleType*, size_t);
+
+private:
+    friend class BiquadCascade<SampleType>;
+    friend class DualBiquadCascade<SampleType>;
+
+    struct Coefficients
+    {
+        SampleType b0;
+        SampleType b1;
+        SampleType b2;
+        SampleType a1;
+        SampleType a2;
+    };
+
+    Coefficients coefficients;
+    Coefficients target;
+    Coefficients increment;
+    int rampRemaining;
+    SampleType state1;
+    SampleType state2;
+
+    // === Private Helper =====================================================
+    void advanceRamp();
+    static SampleType snapToZero(SampleType);
+    static bool isNearZero(SampleType);
+    static double getPoleRadius(SampleType a1, SampleType a2);
+};
\ No newline at end of file
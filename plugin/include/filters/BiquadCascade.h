@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include "Biquad.h"
+
+// runs a chain of biquad sections in one pass over the block. the sections'
+// coefficients and state are gathered into contiguous aligned arrays, the
+// whole chain is run sample by sample with every section kept hot, and the
+// state is handed back to the sections afterwards. only valid while none of
+// the sections are ramping their coefficients
+template <typename SampleType>
+class BiquadCascade
+{
+public:
+    // === Lifecycle ==========================================================
+    BiquadCascade();
+
+    // === Sections ===========================================================
+    void clear();
+    void addSection(Biquad<SampleType>*);
+    inline size_t getNumSections() const { return numSections; }
+    // a gain applied ahead of the chain. it is folded into the b
+    // coefficients of the first section rather than taking a pass of its
+    // own. clear resets it to unity
+    void setInputGain(SampleType);
+    // true when the whole chain, input gain included, leaves the signal
+    // untouched, so processing it can be skipped
+    bool isIdentity() const;
+
+    // === Process Audio ======================================================
+    void processBlock(SampleType*, size_t);
+
+    inline static const size_t maxSections { 16 };
+
+private:
+    friend class DualBiquadCascade<SampleType>;
+
+    Biquad<SampleType>* sections[maxSections];
+    size_t numSections;
+    SampleType inputGain;
+    bool hasInputGain;
+    alignas(16) SampleType b0[maxSections];
+    alignas(16) SampleType b1[maxSections];
+    alignas(16) SampleType b2[maxSections];
+    alignas(16) SampleType a1[maxSections];
+    alignas(16) SampleType a2[maxSections];
+    alignas(16) SampleType state1[maxSections];
+    alignas(16) SampleType state2[maxSections];
+
+    // === Private Helper =====================================================
+    // only needed when there are no sections to fold the gain into
+    void applyInputGain(SampleType*, size_t);
+};
\ No newline at end of file
@@ -1,12 +1,15 @@
 #pragma once
+#include <array>
 #include <atomic>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "ParameterBlueprint.h"
 #include "FilterStateListener.h"
+#include "BiquadCascade.h"
+#include "SmootherBank.h"
 
 using ParameterLayout = juce::AudioProcessorValueTreeState::ParameterLayout;
 
-class CtmFilter : public juce::AudioProcessorValueTreeState::Listener
+class CtmFilter
 {
 public:
     const std::string name;
@@ -14,43 +17,137 @@ public:
     const std::string secondaryParamText;
     
     // === Lifecycle ==========================================================
+    // the filter takes numSmoothed lanes of the bank for the values it ramps
     CtmFilter
-    (std::string name, std::string paramText, std::string secondText = "");
+    (SmootherBank&, size_t numSmoothed, std::string name,
+    std::string paramText, std::string secondText = "");
 
-    // === ValueTreeState Listener ============================================
-    void setListenTo(juce::AudioProcessorValueTreeState*);
-    void stopListeningTo(juce::AudioProcessorValueTreeState*);
-    void parameterChanged(const juce::String&, float) override;
+    // === ValueTreeState =====================================================
+    // the tree's value of each parameter is looked up once here, and polled
+    // by the audio thread at the start of every block from then on. nothing
+    // listens to the tree, so automation never calls into the filter
+    void attachToTree(juce::AudioProcessorValueTreeState*);
     
     // === For EQ Displays ====================================================
     void addStateListener(FilterStateListener*);
     void removeStateListener(FilterStateListener*);
     virtual void getMagnitudes(const double*, double*, size_t) = 0;
+    // polled by the display on the message thread. true when a value the
+    // response is drawn from has changed since the last poll
+    bool hasDisplayChanged();
 
     // === Parameters =========================================================
     void addParameters(ParameterLayout*);
     virtual std::string getOnOffParameter() = 0;
     virtual void getParameters(std::vector<ParameterBlueprint>& container) = 0;
 
-    // === Process Audio ======================================================
-    void link(CtmFilter*);
-    void unlink(CtmFilter*);
-    virtual void setParamsOnLink(std::string) = 0;
+    // === Linking ============================================================
+    // while the link parameter is on, this filter reads its values from the
+    // leader. the link is resolved wherever values are read, so it holds
+    // without an editor and needs no callbacks. only filters of the same
+    // type are linked, so their indices match
+    void followWhenLinked(const CtmFilter* leader, std::atomic<float>* link);
 
     // === Process Audio ======================================================
-    float processSample(float);
+    // compares every parameter with the value last seen and applies only
+    // the ones that changed. audio thread only
+    void applyPendingParameters(bool smooth);
+    // has the next applyPendingParameters apply every parameter, changed or
+    // not, so nothing is left ramping from before a restart
+    void applyAllOnNextBlock();
+    void processBlock(float*, size_t);
+    void processBlock(double*, size_t);
+    void setCoefficientUpdateInterval(int);
+    // called by the processor after the bank moves on, with the lanes that
+    // moved. the filter only hears about its own, and only if any did
+    void onSmoothersAdvanced(uint64_t moved);
+
+    // === Fused Cascade ======================================================
+    // a filter is steady when nothing is smoothing, fading or ramping, which
+    // means its sections can be run as part of a channel wide cascade.
+    // sections are kept at both precisions, so either cascade can be built
+    virtual bool isSteady() = 0;
+    virtual void addSections(BiquadCascade<float>&) = 0;
+    virtual void addSections(BiquadCascade<double>&) = 0;
+
+    // === Active Stages ======================================================
+    // a filter is inactive once it is bypassed and its fade out has ended,
+    // and can then be skipped entirely. the processor only asks again after
+    // takeStageChange, or while a bypass fade is running
+    virtual bool isActive() = 0;
+    virtual bool isBypassFading() = 0;
+    // the largest pole radius of the sections the filter runs, ramp targets
+    // included, which sets how long it rings for once its input stops
+    virtual double getPoleRadius() = 0;
+    // true once after the on/off, order or shelf mode changed. audio thread
+    // only
+    bool takeStageChange();
 
 protected:
-    std::atomic<long long> timeAtLastProcess;
-    juce::AudioProcessorValueTreeState* stateTree;
+    // while parameters are smoothing, coefficients are only redesigned once
+    // per interval and interpolated between design points in the meantime
+    int coefficientUpdateInterval;
+    int samplesUntilUpdate;
 
-    virtual float processSampleProtected(float) = 0;
-    virtual void onChangedParameter(const juce::String&, float) = 0;
+    virtual void processBlockProtected(float*, size_t) = 0;
+    virtual void processBlockProtected(double*, size_t) = 0;
+    // indices are the position of the parameter in getParameters, which
+    // each filter names with an enum of its own
+    virtual void onChangedParameter(size_t index, float) = 0;
+    // true while applying changes the audio thread should smooth towards
     bool isProcessing();
+    // setters call this rather than redesigning coefficients themselves, so
+    // however many values change in a block the filter is redesigned once
+    void requestCoefficientUpdate();
+    virtual void updateCoefficients();
+    // setters of anything that decides whether the filter runs call this
+    void markStageChanged();
+    float getParameterValue(size_t index);
+
+    // the filter's lanes in the bank, numbered from zero. offsets count from
+    // the start of the block being processed
+    float getSmoothed(size_t index, int offset = 0) const;
+    void setSmoothedTarget(size_t index, float value);
+    void setSmoothedValue(size_t index, float value);
+    bool isSmoothing(size_t index, int offset = 0) const;
+    // a bit for each lane still ramping offset samples into the block
+    uint32_t getSmoothing(int offset = 0) const;
+    int getSmoothingRemaining(size_t index) const;
+    // sets the ramp length and lands every lane on its target
+    void resetSmoothed(double sampleRate);
+    // told which of the filter's lanes moved in the block just processed
+    virtual void onSmoothedMoved(uint32_t moved);
     std::string getIdForParameter(const ParameterBlueprint*);
 
+    inline static const int defaultCoefficientUpdateInterval { 16 };
+    // a fixed time rather than one block, so a change renders the same at
+    // any buffer size
+    inline static const double smoothingSeconds { 0.01 };
+    inline static const size_t maxParameters { 16 };
+
 private:
     std::vector<FilterStateListener*> listeners;
-    std::vector<CtmFilter*> linked;
+    SmootherBank& smoothers;
+    const size_t firstLane;
+    const size_t numLanes;
+    // the tree's value of each parameter, and the filter and link parameter
+    // to read them from instead while linked
+    std::array<std::atomic<float>*, maxParameters> sources;
+    const CtmFilter* leader;
+    std::atomic<float>* linkParameter;
+    size_t numParameters;
+    // the values as last applied by the audio thread, and as last drawn by
+    // the display. each is only touched by its own thread
+    std::array<float, maxParameters> appliedValues;
+    std::array<float, maxParameters> displayValues;
+    // parameters to apply on the next block whether they changed or not
+    std::atomic<uint32_t> forcedParameters;
+    bool smoothChanges;
+    bool applyingChanges;
+    bool coefficientsStale;
+    bool stageChanged;
+
+    const CtmFilter& getValueSource() const;
+    float readParameter(const CtmFilter& source, size_t index);
     void nofityListeners();
 };
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <juce_dsp/juce_dsp.h>
+#include "BiquadCascade.h"
+
+// runs the cascades of both channels together, with channel one in the first
+// simd lane and channel two in the second. every lane has its own
+// coefficients, so the channels can use completely different settings. when
+// one channel has fewer sections it is padded with pass-through sections,
+// which leave both the signal and their (zero) state untouched
+template <typename SampleType>
+class DualBiquadCascade
+{
+public:
+    // === Process Audio ======================================================
+    void processBlock
+    (BiquadCascade<SampleType>& one, SampleType* dataOne,
+    BiquadCascade<SampleType>& two, SampleType* dataTwo, size_t numSamples);
+
+private:
+    using Register = juce::dsp::SIMDRegister<SampleType>;
+    using Cascade = BiquadCascade<SampleType>;
+    using Section = Biquad<SampleType>;
+    static_assert(Register::SIMDNumElements >= 2);
+
+    Register b0[Cascade::maxSections];
+    Register b1[Cascade::maxSections];
+    Register b2[Cascade::maxSections];
+    Register a1[Cascade::maxSections];
+    Register a2[Cascade::maxSections];
+    Register state1[Cascade::maxSections];
+    Register state2[Cascade::maxSections];
+
+    // === Private Helper =====================================================
+    static Register pack(SampleType laneOne, SampleType laneTwo);
+    static const Section* getSection(const Cascade&, size_t);
+};
\ No newline at end of file
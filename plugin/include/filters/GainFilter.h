@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 #include "CtmFilter.h"
@@ -7,10 +8,10 @@ class GainFilter : public CtmFilter
 {
 public:
     // === Lifecycle ==========================================================
-    GainFilter(std::string nameArg, std::string displayName);
+    GainFilter(SmootherBank&, std::string nameArg, std::string displayName);
 
     // === Parameters =========================================================
-    void onChangedParameter(const juce::String&, float) override;
+    void onChangedParameter(size_t index, float) override;
     inline std::string getOnOffParameter() override
         { return getIdForParameter(&onOffParam); }
     inline std::string getGainParameter()
@@ -20,16 +21,39 @@ public:
     void setGain(float);
     void setBypass(bool);
 
-    // === Linking ============================================================
-    void setParamsOnLink(std::string) override;
-
     // === Process Audio ======================================================
-    void reset(int blockSize);
-    float processSampleProtected(float) override;
+    void reset(double sampleRate);
+    void processBlockProtected(float*, size_t) override;
+    void processBlockProtected(double*, size_t) override;
+    bool isSteady() override;
+    void addSections(BiquadCascade<float>&) override;
+    void addSections(BiquadCascade<double>&) override;
+    bool isActive() override;
+    bool isBypassFading() override;
+    double getPoleRadius() override;
+    // while steady, the gain is handed to a fused cascade to fold into its
+    // first section instead of being processed. false when it is ramping,
+    // in which case it has to be processed as a block
+    bool foldInto(BiquadCascade<float>&);
+    bool foldInto(BiquadCascade<double>&);
 
 private:
-    juce::SmoothedValue<float> smoothGain;
-    juce::SmoothedValue<float> smoothBypass;
+    // the gain in decibels and the bypass fade, as lanes of the bank
+    enum Smoothed : size_t { smoothGain, smoothBypass, numSmoothed };
+    // the current gain as a multiplier, so pow only runs while ramping
+    float linearGain;
+
+    // === Private Helper =====================================================
+    void onSmoothedMoved(uint32_t moved) override;
+    bool isUnity();
+    void updateLinearGain();
+    template <typename SampleType>
+    void processBlockInternal(SampleType*, size_t);
+    // the gain for length samples from offset into the block
+    template <typename SampleType>
+    void fillGainCurve(SampleType*, size_t offset, size_t length);
+    template <typename SampleType>
+    bool foldIntoInternal(BiquadCascade<SampleType>&);
 
     // === Static Constants ===================================================
     inline static const ParameterBlueprint onOffParam {
@@ -45,4 +69,24 @@ private:
             .withMaxDecimals(1)
             .withUnits("dB")
     };
+
+    // === Parameter Table ====================================================
+    // indexed by ParameterIndex, in the order the parameters were first
+    // published in, which hosts rely on for automation
+    enum ParameterIndex : size_t
+    {
+        onOffIndex,
+        gainIndex,
+        numParameters
+    };
+    inline static const std::array<const ParameterBlueprint*, numParameters>
+        parameterTable
+    {{
+        &onOffParam,
+        &gainParam
+    }};
+    static_assert(numParameters <= maxParameters);
+
+    // ramps are applied as a curve of this many samples at a time
+    inline static const size_t curveLength { 64 };
 };
\ No newline at end of file
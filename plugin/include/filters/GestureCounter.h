@@ -0,0 +1,41 @@
+#pragma once
+#include <atomic>
+#include <bitset>
+#include <juce_audio_processors/juce_audio_processors.h>
+
+// counts the host notifications sent between the start and end of each
+// gesture, overlapping gestures counting as one, along with how many
+// different parameters they were for. moving a linked control should cost a
+// single notification, however many filters follow it, and a transaction
+// one for each parameter it changes
+class GestureCounter : private juce::AudioProcessorParameter::Listener
+{
+public:
+    // === Lifecycle ==========================================================
+    GestureCounter();
+    void attachTo(juce::AudioProcessor&);
+    void detachFrom(juce::AudioProcessor&);
+
+    // === Any Thread =========================================================
+    int getLastGestureCount() const;
+    int getMostInAGesture() const;
+    // the most notifications any gesture sent beyond one for each parameter
+    // it changed, which should stay at 0
+    int getMostRepeatedInAGesture() const;
+
+private:
+    inline static const size_t maxParameters { 256 };
+
+    std::atomic<int> openGestures;
+    std::atomic<int> count;
+    std::atomic<int> lastCount;
+    std::atomic<int> mostCount;
+    std::atomic<int> mostRepeated;
+    // the parameters notified during the open gesture. only touched by the
+    // thread making the gesture
+    std::bitset<maxParameters> changed;
+
+    // === Parameter Listener =================================================
+    void parameterValueChanged(int index, float value) override;
+    void parameterGestureChanged(int index, bool isStarting) override;
+};
\ No newline at end of file
@@ -1,7 +1,11 @@
 #pragma once
+#include <array>
+#include <type_traits>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 #include "CtmFilter.h"
+#include "Biquad.h"
+#include "SmootherBank.h"
 
 namespace dsp = juce::dsp;
 
@@ -10,10 +14,11 @@ class LowPassFilter : public CtmFilter
 public:
     // === Lifecycle ==========================================================
     LowPassFilter
-    (std::string name, std::string parameterText, std::string secondParamText);
+    (SmootherBank&, std::string name, std::string parameterText,
+    std::string secondParamText);
 
     // === Parameter Information ==============================================
-    void onChangedParameter(const juce::String&, float) override;
+    void onChangedParameter(size_t index, float) override;
     inline std::string getOnOffParameter() override
         { return getIdForParameter(&onOffParam); }
     inline std::string getShelfModeParameter()
@@ -34,7 +39,7 @@ public:
     void getMagnitudes(const double*, double*, size_t) override;
 
     // === Set Parameters =====================================================
-    void reset(double newSampleRate, int samplesPerBlock);
+    void reset(double newSampleRate);
     void setBypass(bool);
     void setCutFrequency(float);
     void setShelfFrequency(float);
@@ -44,27 +49,38 @@ public:
     void setIsShelf(bool);
     void setShelfGain(float);
 
-    // === Linking ============================================================
-    void setParamsOnLink(std::string) override;
-
     // === Process Audio ======================================================
-    void prepare(const dsp::ProcessSpec&);
-    float processSampleProtected(float) override;
+    void processBlockProtected(float*, size_t) override;
+    void processBlockProtected(double*, size_t) override;
+    bool isSteady() override;
+    void addSections(BiquadCascade<float>&) override;
+    void addSections(BiquadCascade<double>&) override;
+    bool isActive() override;
+    bool isBypassFading() override;
+    double getPoleRadius() override;
 
 private:
     // === Private Variables ==================================================
     // filters 1~3 are always second order, filter 4 is always first order
-    // different combinations can create a filter of any order from 1 to 7
-    dsp::IIR::Filter<float> filterOne;
-    dsp::IIR::Filter<float> filterTwo;
-    dsp::IIR::Filter<float> filterThree;
-    dsp::IIR::Filter<float> filterFour;
-    juce::SmoothedValue<float> smoothCutFreq;
-    juce::SmoothedValue<float> smoothShelfFreq;
-    juce::SmoothedValue<float> smoothBypass;
-    juce::SmoothedValue<float> smoothGain;
-    juce::SmoothedValue<float> smoothCutRes;
-    juce::SmoothedValue<float> smoothShelfRes;
+    // different combinations can create a filter of any order from 1 to 7.
+    // a set is kept for each sample precision the host might ask for
+    template <typename SampleType>
+    struct Sections
+    {
+        Biquad<SampleType> one;
+        Biquad<SampleType> two;
+        Biquad<SampleType> three;
+        Biquad<SampleType> four;
+    };
+    Sections<float> floatSections;
+    Sections<double> doubleSections;
+    // the values the sections are designed from and the bypass fade, as
+    // lanes of the bank
+    enum Smoothed : size_t
+    {
+        smoothCutFreq, smoothShelfFreq, smoothGain, smoothCutRes,
+        smoothShelfRes, smoothBypass, numSmoothed
+    };
     int order;
     int pendingOrder;
     int fadeSamples;
@@ -128,22 +144,118 @@ private:
             .withDefault(0.71f)
             .withMaxDecimals(2)
     };
+    // === Parameter Table ====================================================
+    // indexed by ParameterIndex, in the order the parameters were first
+    // published in, which hosts rely on for automation
+    enum ParameterIndex : size_t
+    {
+        onOffIndex,
+        cutFreqIndex,
+        shelfFreqIndex,
+        falloffIndex,
+        cutResIndex,
+        shelfResIndex,
+        shelfModeIndex,
+        shelfGainIndex,
+        numParameters
+    };
+    inline static const std::array<const ParameterBlueprint*, numParameters>
+        parameterTable
+    {{
+        &onOffParam,
+        &cutFreqParam,
+        &shelfFreqParam,
+        &falloffParam,
+        &cutResParam,
+        &shelfResParam,
+        &shelfModeParam,
+        &shelfGainParam
+    }};
+    static_assert(numParameters <= maxParameters);
+
     inline static const int fadeLength { 200 };
+    // which smoothed values each section is designed from
+    inline static const uint32_t allInputs { (1u << smoothBypass) - 1 };
+    inline static const uint32_t cutInputs {
+        (1u << smoothCutFreq) | (1u << smoothCutRes)
+    };
+    inline static const uint32_t shelfInputs {
+        (1u << smoothShelfFreq) | (1u << smoothShelfRes) | (1u << smoothGain)
+    };
+    inline static const uint32_t firstOrderInputs { 1u << smoothCutFreq };
+    // butterworth q of each second order section, indexed by order and then
+    // by section. orders 0 and 1 have no second order sections
+    inline static constexpr std::array<std::array<float, 3>, 8> butterworthQ
+    {{
+        { 0.707f, 0.707f, 0.707f },
+        { 0.707f, 0.707f, 0.707f },
+        { 0.707f, 0.707f, 0.707f },
+        { 1.000f, 0.707f, 0.707f },
+        { 0.541f, 1.307f, 0.707f },
+        { 0.618f, 1.618f, 0.707f },
+        { 0.518f, 0.707f, 1.932f },
+        { 0.555f, 0.802f, 2.247f }
+    }};
 
     // === Private Helper =====================================================
-    void updateFilters();
+    void updateCoefficients() override;
+    // only sections built from a value set in moved are redesigned, from
+    // the values offset samples into the block
     void updateFilters
-    (float cutFreq, float shelfFreq, float gain, float cutRes, float shelfRes);
-    void delayedUpdateOrder();
-    bool anythingSmoothing();
+    (uint32_t moved = allInputs, int offset = 0, int rampLength = 0);
+    void updateFiltersAtControlRate(int offset);
+    template <typename SampleType>
+    SampleType processSampleInternal(SampleType, int offset);
+    template <typename SampleType>
+    void processBlockInternal(SampleType*, size_t);
+    template <typename SampleType>
+    void addSectionsInternal(BiquadCascade<SampleType>&);
+    template <typename SampleType>
+    double getPoleRadiusInternal();
+    template <typename SampleType>
+    inline Sections<SampleType>& getSections()
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+            return floatSections;
+        else
+            return doubleSections;
+    }
+    void delayedUpdateOrder(int offset);
+    bool anythingSmoothing(int offset = 0);
+    bool anythingTransitioning();
     float getQForFilter(int, int, float);
     void combineMagnitudes(double* totals, const double* toCombine, size_t);
-    inline bool filterOneEnabled() { return order >= 2 && !isShelf; }
-    inline bool filterTwoEnabled() { return order >= 4 && !isShelf; }
-    inline bool filterThreeEnabled() { return order >= 6 && !isShelf; }
-    inline bool filterFourEnabled() { return order % 2 == 1 || isShelf; }
-    inline bool filterOneEnabled(int ord) { return ord >= 2 && !isShelf; }
-    inline bool filterTwoEnabled(int ord) { return ord >= 4 && !isShelf; }
-    inline bool filterThreeEnabled(int ord) { return ord >= 6 && !isShelf; }
-    inline bool filterFourEnabled(int ord) { return ord % 2 == 1 || isShelf; }
+    inline bool filterOneEnabled() { return filterOneEnabled(order, isShelf); }
+    inline bool filterTwoEnabled() { return filterTwoEnabled(order, isShelf); }
+    inline bool filterThreeEnabled()
+        { return filterThreeEnabled(order, isShelf); }
+    inline bool filterFourEnabled()
+        { return filterFourEnabled(order, isShelf); }
+    inline static constexpr bool filterOneEnabled(int ord, bool shelf)
+        { return ord >= 2 && !shelf; }
+    inline static constexpr bool filterTwoEnabled(int ord, bool shelf)
+        { return ord >= 4 && !shelf; }
+    inline static constexpr bool filterThreeEnabled(int ord, bool shelf)
+        { return ord >= 6 && !shelf; }
+    inline static constexpr bool filterFourEnabled(int ord, bool shelf)
+        { return ord % 2 == 1 || shelf; }
+    // shelf mode ignores the order, so it shares a slot with the unused 0
+    inline int getTopology() { return isShelf ? 0 : order; }
+
+    // === Topology Kernels ===================================================
+    // every order and the shelf have their own instantiation with the
+    // enabled sections fixed at compile time. the one to use is looked up
+    // from a table instead of testing each section as the audio is run
+    template <typename SampleType>
+    using BlockKernel = void (*)(Sections<SampleType>&, SampleType*, size_t);
+    template <typename SampleType>
+    using SampleKernel = SampleType (*)(Sections<SampleType>&, SampleType);
+    template <typename SampleType, int Order, bool Shelf>
+    static void processFilters(Sections<SampleType>&, SampleType*, size_t);
+    template <typename SampleType, int Order, bool Shelf>
+    static SampleType processFilters(Sections<SampleType>&, SampleType);
+    template <typename SampleType>
+    BlockKernel<SampleType> getBlockKernel();
+    template <typename SampleType>
+    SampleKernel<SampleType> getSampleKernel();
 };
\ No newline at end of file
@@ -1,8 +1,12 @@
 #pragma once
+#include <array>
 #include <mutex>
+#include <type_traits>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 #include "CtmFilter.h"
+#include "Biquad.h"
+#include "SmootherBank.h"
 #include "FilterStateListener.h"
 
 namespace dsp = juce::dsp;
@@ -11,10 +15,12 @@ class PeakFilter : public CtmFilter
 {
 public:
     // === Lifecycle ==========================================================
-    PeakFilter(std::string nameArg, std::string paramText, float defaultFreq);
+    PeakFilter
+    (SmootherBank&, std::string nameArg, std::string paramText,
+    float defaultFreq);
 
     // === Parameter Information ==============================================
-    void onChangedParameter(const juce::String&, float) override;
+    void onChangedParameter(size_t index, float) override;
     inline std::string getOnOffParameter() override
         { return name + "-" + onOffParam.idPostfix; }
     inline std::string getFrequencyParameter()
@@ -27,26 +33,33 @@ public:
     void getMagnitudes(const double*, double*, size_t) override;
 
     // === Set Parameters =====================================================
-    void reset(double newSampleRate, int samplesPerBlock);
+    void reset(double newSampleRate);
     void setBypass(bool);
     void setFrequency(float);
     void setGain(float);
     void setQFactor(float);
 
-    // === Linking ============================================================
-    void setParamsOnLink(std::string) override;
-
     // === Process Audio ======================================================
-    void prepare(const dsp::ProcessSpec&);
-    float processSampleProtected(float) override;
+    void processBlockProtected(float*, size_t) override;
+    void processBlockProtected(double*, size_t) override;
+    bool isSteady() override;
+    void addSections(BiquadCascade<float>&) override;
+    void addSections(BiquadCascade<double>&) override;
+    bool isActive() override;
+    bool isBypassFading() override;
+    double getPoleRadius() override;
 
 private:
-    dsp::IIR::Filter<float> filter;
-    juce::SmoothedValue<float> smoothFrequency;
+    // one section for each sample precision the host might ask for
+    Biquad<float> floatFilter;
+    Biquad<double> doubleFilter;
+    // the section is designed from the first three, and the bypass fades
+    // the audio. all four are lanes of the bank
+    enum Smoothed : size_t
+    {
+        smoothFreq, smoothGain, smoothQ, smoothBypass, numSmoothed
+    };
     const float defaultFreq;
-    juce::SmoothedValue<float> smoothBypass;
-    float gain;
-    float q;
     double sampleRate;
     
     // === Parameter Settings =================================================
@@ -70,15 +83,58 @@ private:
             .withMaxDecimals(2)
     };
     inline static const std::string freqParamIdPostfix { "freq" };
-    inline ParameterBlueprint getFreqParameterFields()
-    {
-        return ParameterBlueprint(freqParamIdPostfix, "Frequency")
+    inline static const ParameterBlueprint freqParam {
+        ParameterBlueprint(freqParamIdPostfix, "Frequency")
             .withRange(20, 20000, 0.1f, 0.35f)
-            .withDefault(defaultFreq)
             .withMaxDecimals(1)
-            .withUnits("Hz");
+            .withUnits("Hz")
+    };
+    // the default frequency is the only field that differs between peaks
+    inline ParameterBlueprint getFreqParameterFields()
+    {
+        return ParameterBlueprint(freqParam).withDefault(defaultFreq);
     }
 
+    // === Parameter Table ====================================================
+    // indexed by ParameterIndex, in the order the parameters were first
+    // published in, which hosts rely on for automation
+    enum ParameterIndex : size_t
+    {
+        onOffIndex,
+        gainIndex,
+        qIndex,
+        freqIndex,
+        numParameters
+    };
+    inline static const std::array<const ParameterBlueprint*, numParameters>
+        parameterTable
+    {{
+        &onOffParam,
+        &gainParam,
+        &qParam,
+        &freqParam
+    }};
+    static_assert(numParameters <= maxParameters);
+
+    inline static const uint32_t designInputs { (1u << smoothBypass) - 1 };
+
     // === Private Helper =====================================================
-    void setFilterParameters(float freq, float gain, float q);
+    void updateCoefficients() override;
+    // ramps while processing, otherwise jumps and redesigns with the batch
+    void setSmoothed(Smoothed index, float value);
+    // designs the section from the values offset samples into the block
+    void setFilterParameters(int offset = 0, int rampLength = 0);
+    void updateFilterAtControlRate(int offset);
+    template <typename SampleType>
+    SampleType processSampleInternal(SampleType, int offset);
+    template <typename SampleType>
+    void processBlockInternal(SampleType*, size_t);
+    template <typename SampleType>
+    inline Biquad<SampleType>& getFilter()
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+            return floatFilter;
+        else
+            return doubleFilter;
+    }
 };
\ No newline at end of file
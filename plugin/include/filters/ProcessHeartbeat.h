@@ -0,0 +1,31 @@
+#pragma once
+#include <atomic>
+
+// published by the audio thread once per block, so that other threads can
+// tell whether audio is currently being processed without touching the
+// per-sample path. it goes by the clock, so the audio thread never uses it
+// to decide how to process
+class ProcessHeartbeat
+{
+public:
+    // === Lifecycle ==========================================================
+    ProcessHeartbeat();
+    // forgets the last beat, so audio counts as stopped until the next one
+    void reset();
+
+    // === Audio Thread =======================================================
+    void beat(int numSamples, double sampleRate);
+
+    // === Any Thread =========================================================
+    bool isAlive() const;
+
+private:
+    std::atomic<long long> timeAtLastBeat;
+    std::atomic<long long> tolerance;
+
+    // === Static Constants ===================================================
+    inline static const long long minTolerance { 2 };
+
+    // === Private Helper =====================================================
+    static long long now();
+};
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// linear ramps for every value the filters smooth, coefficient inputs, gains
+// and bypass fades alike, kept side by side in plain arrays rather than one
+// juce::SmoothedValue each. the processor owns the one bank and moves every
+// ramp on together once a block has been processed, with a branch free loop
+// the compiler turns into simd. in between, the filters read where their
+// ramps are at any offset into the block. audio thread only, apart from
+// handing out lanes
+class SmootherBank
+{
+public:
+    inline static const size_t maxValues { 64 };
+
+    // === Lifecycle ==========================================================
+    SmootherBank();
+    // hands out count neighbouring lanes and returns the first. called as
+    // the filters are made, before anything is processed
+    size_t allocate(size_t count);
+    // sets the ramp length and lands the given lanes on their targets
+    void reset
+    (size_t first, size_t count, double sampleRate, double rampSeconds);
+
+    // === Values =============================================================
+    // ramps from wherever the lane is now, over the bank's ramp length
+    void setTarget(size_t lane, float value);
+    void setCurrentAndTarget(size_t lane, float value);
+    // the value offset samples into the block about to be processed.
+    // offsets past the end of the block follow the ramp as it stands
+    float getValue(size_t lane, int offset) const;
+    // samples of ramp left from the start of the block
+    int getRemaining(size_t lane) const;
+    // a bit for each of count lanes from first that is still ramping offset
+    // samples into the block
+    uint32_t getSmoothing(size_t first, size_t count, int offset) const;
+
+    // === Audio Thread =======================================================
+    // moves every ramp on by numSamples once a block has been processed,
+    // and returns a mask with a bit set for each lane that moved
+    uint64_t advance(int numSamples);
+
+private:
+    std::array<float, maxValues> current;
+    std::array<float, maxValues> target;
+    std::array<float, maxValues> increment;
+    // kept as floats so they run in the same vector lanes as the values
+    std::array<float, maxValues> remaining;
+    size_t numAllocated;
+    int rampLength;
+};
\ No newline at end of file
@@ -3,7 +3,6 @@
 #include "ParameterControl.h"
 #include "ParameterToggle.h"
 #include "GainFilter.h"
-#include "Linkable.h"
 
 class GainControl : public FilterControl<GainFilter>
 {
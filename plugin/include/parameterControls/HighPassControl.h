@@ -4,7 +4,6 @@
 #include "ParameterControl.h"
 #include "ParameterToggle.h"
 #include "HighPassFilter.h"
-#include "Linkable.h"
 
 class HighPassControl : public FilterControl<HighPassFilter>
 {
@@ -4,7 +4,6 @@
 #include "ParameterControl.h"
 #include "ParameterToggle.h"
 #include "LowPassFilter.h"
-#include "Linkable.h"
 
 class LowPassControl : public FilterControl<LowPassFilter>
 {
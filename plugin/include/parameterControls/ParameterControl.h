@@ -2,13 +2,10 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "CtmSlider.h"
 #include "SliderLabel.h"
-#include "Linkable.h"
 
 using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
 
-class ParameterControl :
-    juce::AudioProcessorValueTreeState::Listener,
-    Linkable<ParameterControl>
+class ParameterControl
 {
 public:
     std::string parameterName;
@@ -18,7 +15,6 @@ public:
 
     // === Lifecycle ==========================================================
     ParameterControl();
-    ~ParameterControl() override;
 
     // === Settings ===========================================================
     void setBounds(juce::Rectangle<int>);
@@ -28,17 +24,7 @@ public:
     (juce::AudioProcessorValueTreeState*, std::string);
     void setSliderStyle(juce::Slider::SliderStyle);
 
-    // === Parameter Linking ==================================================
-    void link(const ParameterControl*) override;
-    void unlink(const ParameterControl*) override;
-    void linkParameterBidirectional(ParameterControl*);
-    void unlinkParameterBidirectional(ParameterControl*);
-    void parameterChanged(const juce::String&, float) override;
 private:
-    juce::AudioProcessorValueTreeState* tree;
-    std::vector<std::string> linkedParameters;
     juce::Rectangle<int> bounds;
     bool everAttached;
-
-    void copyValueToParameter(const std::string, float);
 };
\ No newline at end of file
@@ -3,13 +3,10 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "CtmToggle.h"
 #include "ParameterToggle.h"
-#include "Linkable.h"
 
 using ButtonAttachment = juce::AudioProcessorValueTreeState::ButtonAttachment;
 
-class ParameterToggle :
-    public juce::AudioProcessorValueTreeState::Listener,
-    public Linkable<ParameterToggle>
+class ParameterToggle : public juce::AudioProcessorValueTreeState::Listener
 {
 public:
     std::string parameterName;
@@ -30,15 +27,6 @@ public:
     // === ValueTreeState Listener ============================================
     void parameterChanged(const juce::String&, float) override;
 
-    // === Linking ============================================================
-    void link(const ParameterToggle*) override;
-    void unlink(const ParameterToggle*) override;
-    void linkToggleBidirectional(ParameterToggle*);
-    void unlinkToggleBidirectional(ParameterToggle*);
-
 private:
     juce::AudioProcessorValueTreeState* tree;
-    std::vector<std::string> linkedToggles;
-
-    void copyValueToParameter(const std::string, float);
 };
\ No newline at end of file
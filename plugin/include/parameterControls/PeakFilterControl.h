@@ -4,7 +4,6 @@
 #include "ParameterControl.h"
 #include "ParameterToggle.h"
 #include "PeakFilter.h"
-#include "Linkable.h"
 
 class PeakFilterControl : public FilterControl<PeakFilter>
 {
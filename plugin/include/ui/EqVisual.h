@@ -3,7 +3,8 @@
 #include "FilterStateListener.h"
 #include "CtmFilter.h"
 
-class EqVisual : public juce::Component, public FilterStateListener
+class EqVisual
+    : public juce::Component, public FilterStateListener, private juce::Timer
 {
 public:
     /// === Lifecycle =========================================================
@@ -18,6 +19,9 @@ public:
     void addToFirstResponse(CtmFilter*);
     void addToSecondResponse(CtmFilter*);
     void notify(CtmFilter*) override;
+    // parameter changes are picked up by polling the filters, so the host's
+    // automation thread never has to call into the ui
+    void timerCallback() override;
 
     // === Parameters =========================================================
     void setFrequencyResponseColors(juce::Colour, juce::Colour);
@@ -45,6 +49,7 @@ private:
     inline static const int majorHorzLineExtraExtension { 8 };
     inline static const int majorVertLineExtraExtension { 4 };
     inline static const int freqResponseExtension { 24 };
+    inline static const int refreshRate { 30 };
 
     // === Drawing Helper Functions ===========================================
     void drawBackground(juce::Graphics&);
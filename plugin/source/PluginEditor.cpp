@@ -219,54 +219,14 @@ void PluginEditor::initializeGlobalControls()
     linkAllButton.setText("Link All");
     linkAllButton.onClick = [this]
     {
-        juce::AudioProcessorValueTreeState* stateTree = &processorRef.tree;
-        stateTree->undoManager->beginNewTransaction();
-        stateTree->getParameter("gain-linked")->beginChangeGesture();
-        stateTree->getParameter("gain-linked")->setValueNotifyingHost(1);
-        stateTree->getParameter("gain-linked")->endChangeGesture();
-        stateTree->getParameter("hpf-linked")->beginChangeGesture();
-        stateTree->getParameter("hpf-linked")->setValueNotifyingHost(1);
-        stateTree->getParameter("hpf-linked")->endChangeGesture();
-        stateTree->getParameter("peak12-linked")->beginChangeGesture();
-        stateTree->getParameter("peak12-linked")->setValueNotifyingHost(1);
-        stateTree->getParameter("peak12-linked")->endChangeGesture();
-        stateTree->getParameter("peak34-linked")->beginChangeGesture();
-        stateTree->getParameter("peak34-linked")->setValueNotifyingHost(1);
-        stateTree->getParameter("peak34-linked")->endChangeGesture();
-        stateTree->getParameter("peak56-linked")->beginChangeGesture();
-        stateTree->getParameter("peak56-linked")->setValueNotifyingHost(1);
-        stateTree->getParameter("peak56-linked")->endChangeGesture();
-        stateTree->getParameter("lpf-linked")->beginChangeGesture();
-        stateTree->getParameter("lpf-linked")->setValueNotifyingHost(1);
-        stateTree->getParameter("lpf-linked")->endChangeGesture();
-        processorRef.notifyHostOfStateChange();
+        processorRef.setAllLinked(true);
         checkGlobalLinkButtonState();
     };
     addAndMakeVisible(linkAllButton);
     unlinkAllButton.setText("Unlink");
     unlinkAllButton.onClick = [this]
     {
-        juce::AudioProcessorValueTreeState* stateTree = &processorRef.tree;
-        stateTree->undoManager->beginNewTransaction();
-        stateTree->getParameter("gain-linked")->beginChangeGesture();
-        stateTree->getParameter("gain-linked")->setValueNotifyingHost(0);
-        stateTree->getParameter("gain-linked")->endChangeGesture();
-        stateTree->getParameter("hpf-linked")->beginChangeGesture();
-        stateTree->getParameter("hpf-linked")->setValueNotifyingHost(0);
-        stateTree->getParameter("hpf-linked")->endChangeGesture();
-        stateTree->getParameter("peak12-linked")->beginChangeGesture();
-        stateTree->getParameter("peak12-linked")->setValueNotifyingHost(0);
-        stateTree->getParameter("peak12-linked")->endChangeGesture();
-        stateTree->getParameter("peak34-linked")->beginChangeGesture();
-        stateTree->getParameter("peak34-linked")->setValueNotifyingHost(0);
-        stateTree->getParameter("peak34-linked")->endChangeGesture();
-        stateTree->getParameter("peak56-linked")->beginChangeGesture();
-        stateTree->getParameter("peak56-linked")->setValueNotifyingHost(0);
-        stateTree->getParameter("peak56-linked")->endChangeGesture();
-        stateTree->getParameter("lpf-linked")->beginChangeGesture();
-        stateTree->getParameter("lpf-linked")->setValueNotifyingHost(0);
-        stateTree->getParameter("lpf-linked")->endChangeGesture();
-        processorRef.notifyHostOfStateChange();
+        processorRef.setAllLinked(false);
         checkGlobalLinkButtonState();
     };
     addAndMakeVisible(unlinkAllButton);
@@ -275,9 +235,7 @@ void PluginEditor::initializeGlobalControls()
     resetButton.setDisplayAlwaysUp(true);
     resetButton.onClick = [this]
     {
-        processorRef.tree.undoManager->beginNewTransaction();
         processorRef.resetAllParams();
-        processorRef.notifyHostOfStateChange();
     };
     addAndMakeVisible(resetButton);
     auto notif = juce::sendNotification;
@@ -370,17 +328,13 @@ T* toggledFilter)
     linkButton->addOnToggleFunction(
         [this, control, toggledFilter, untoggledFilter] (bool toggled)
         {
+            // the processor links the filters themselves, so only the
+            // controls need to move over to the leader
             juce::AudioProcessorValueTreeState* tree = &processorRef.tree;
             if (toggled)
-            {
-                toggledFilter->link(untoggledFilter);
                 control->attachToFilter(tree, toggledFilter);
-            }
             else
-            {
-                toggledFilter->unlink(untoggledFilter);
                 control->attachToFilter(tree, untoggledFilter);
-            }
             checkGlobalLinkButtonState();
         }
     );
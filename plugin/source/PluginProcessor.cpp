@@ -1,6 +1,9 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 #include "ParameterBlueprint.h"
+#include <bit>
+#include <cmath>
+#include <limits>
 
 // === Lifecycle ==============================================================
 PluginProcessor::PluginProcessor()
@@ -12,40 +15,74 @@ PluginProcessor::PluginProcessor()
 		.withOutput("Output", juce::AudioChannelSet::stereo(), true)
 #endif
 	),
-	gainOne("gain1", "Gain M/L {0}"),
-	gainTwo("gain2", "Gain S/R {0}"),
-	highPassOne("hpf1", "Low-Cut M/L {0}", "Low-Shelf M/L {0}"),
-	highPassTwo("hpf2", "Low-Cut S/R {0}", "Low-Shelf S/R {0}"),
-	peakOne("peak1", "Peak 1 M/L {0}", 200),
-	peakTwo("peak2", "Peak 1 S/R {0}", 200),
-	peakThree("peak3", "Peak 2 M/L {0}", 1000),
-	peakFour("peak4", "Peak 2 S/R {0}", 1000),
-	peakFive("peak5", "Peak 3 M/L {0}", 6000),
-	peakSix("peak6", "Peak 3 S/R {0}", 6000),
-	lowPassOne("lpf1", "High-Cut M/L {0}", "High-Shelf M/L {0}"),
-	lowPassTwo("lpf2", "High-Cut S/R {0}", "High-Shelf S/R {0}"),
+	gainOne(smoothers, "gain1", "Gain M/L {0}"),
+	gainTwo(smoothers, "gain2", "Gain S/R {0}"),
+	highPassOne(smoothers, "hpf1", "Low-Cut M/L {0}", "Low-Shelf M/L {0}"),
+	highPassTwo(smoothers, "hpf2", "Low-Cut S/R {0}", "Low-Shelf S/R {0}"),
+	peakOne(smoothers, "peak1", "Peak 1 M/L {0}", 200),
+	peakTwo(smoothers, "peak2", "Peak 1 S/R {0}", 200),
+	peakThree(smoothers, "peak3", "Peak 2 M/L {0}", 1000),
+	peakFour(smoothers, "peak4", "Peak 2 S/R {0}", 1000),
+	peakFive(smoothers, "peak5", "Peak 3 M/L {0}", 6000),
+	peakSix(smoothers, "peak6", "Peak 3 S/R {0}", 6000),
+	lowPassOne(smoothers, "lpf1", "High-Cut M/L {0}", "High-Shelf M/L {0}"),
+	lowPassTwo(smoothers, "lpf2", "High-Cut S/R {0}", "High-Shelf S/R {0}"),
 	tree(*this, &undoManager, "PARAMETERS", createParameters()),
-	lastSampleRate(44100) // default value
+	lastSampleRate(44100), // default value
+	lastBlockSize(0), processedSincePrepare(false), samplePosition(0),
+	tailSeconds(std::numeric_limits<double>::infinity()),
+	tailSamples(std::numeric_limits<double>::infinity()), silentSamples(0),
+	stagesSteady(false), binaryState(*this),
+	useDoubleState(false), doubleStateActive(false),
+	modeParameter(tree.getRawParameterValue("mode")),
+	midSideActive(false), modeFadeSamples(-1)
 {
 #if PERFETTO
     MelatoninPerfetto::get().beginSession();
 #endif
-	gainOne.setListenTo(&tree);
-	gainTwo.setListenTo(&tree);
-	highPassOne.setListenTo(&tree);
-	highPassTwo.setListenTo(&tree);
-	peakOne.setListenTo(&tree);
-	peakTwo.setListenTo(&tree);
-	peakThree.setListenTo(&tree);
-	peakFour.setListenTo(&tree);
-	peakFive.setListenTo(&tree);
-	peakSix.setListenTo(&tree);
-	lowPassOne.setListenTo(&tree);
-	lowPassTwo.setListenTo(&tree);
+	gainOne.attachToTree(&tree);
+	gainTwo.attachToTree(&tree);
+	highPassOne.attachToTree(&tree);
+	highPassTwo.attachToTree(&tree);
+	peakOne.attachToTree(&tree);
+	peakTwo.attachToTree(&tree);
+	peakThree.attachToTree(&tree);
+	peakFour.attachToTree(&tree);
+	peakFive.attachToTree(&tree);
+	peakSix.attachToTree(&tree);
+	lowPassOne.attachToTree(&tree);
+	lowPassTwo.attachToTree(&tree);
+	filterLinks = {{
+		{ "gain-linked", &gainOne, &gainTwo },
+		{ "hpf-linked", &highPassOne, &highPassTwo },
+		{ "peak12-linked", &peakOne, &peakTwo },
+		{ "peak34-linked", &peakThree, &peakFour },
+		{ "peak56-linked", &peakFive, &peakSix },
+		{ "lpf-linked", &lowPassOne, &lowPassTwo }
+	}};
+	for (const FilterLink& link : filterLinks)
+	{
+		std::atomic<float>* linked = tree.getRawParameterValue(link.id);
+		link.follower->followWhenLinked(link.leader, linked);
+	}
+	stagesOne.filters = {{
+		&highPassOne, &peakOne, &peakThree, &peakFive, &lowPassOne
+	}};
+	stagesTwo.filters = {{
+		&highPassTwo, &peakTwo, &peakFour, &peakSix, &lowPassTwo
+	}};
+	for (ChannelStages* stages : { &stagesOne, &stagesTwo })
+	{
+		stages->numActive = 0;
+		// every filter starts out changed, so the first block builds the list
+		stages->fading = false;
+	}
+	gestureCounter.attachTo(*this);
 }
 
 PluginProcessor::~PluginProcessor() 
 {
+	gestureCounter.detachFrom(*this);
 	while (paramListeners.size() > 0)
 	{
 		ParameterListener* listener = paramListeners.front();
@@ -53,8 +90,6 @@ PluginProcessor::~PluginProcessor()
 		tree.removeParameterListener(listener->parameter, listener);
 		delete listener;
 	}
-	highPassOne.stopListeningTo(&tree);
-	highPassTwo.stopListeningTo(&tree);
 #if PERFETTO
     MelatoninPerfetto::get().endSession();
 #endif
@@ -144,82 +179,162 @@ bool PluginProcessor::isBusesLayoutSupported(const BusesLayout &layouts) const
 void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
 	lastSampleRate = sampleRate;
-	dsp::ProcessSpec spec;
-	spec.sampleRate = sampleRate;
-	spec.maximumBlockSize = (unsigned) samplesPerBlock;
-	spec.numChannels = (unsigned) getTotalNumOutputChannels();
-	gainOne.reset(samplesPerBlock);
-	gainTwo.reset(samplesPerBlock);
-	highPassOne.reset(sampleRate, samplesPerBlock);
-	highPassOne.prepare(spec);
-	highPassTwo.reset(sampleRate, samplesPerBlock);
-	highPassTwo.prepare(spec);
-	peakOne.reset(sampleRate, samplesPerBlock);
-	peakOne.prepare(spec);
-	peakTwo.reset(sampleRate, samplesPerBlock);
-	peakTwo.prepare(spec);
-	peakThree.reset(sampleRate, samplesPerBlock);
-	peakThree.prepare(spec);
-	peakFour.reset(sampleRate, samplesPerBlock);
-	peakFour.prepare(spec);
-	peakFive.reset(sampleRate, samplesPerBlock);
-	peakFive.prepare(spec);
-	peakSix.reset(sampleRate, samplesPerBlock);
-	peakSix.prepare(spec);
-	lowPassOne.reset(sampleRate, samplesPerBlock);
-	lowPassOne.prepare(spec);
-	lowPassTwo.reset(sampleRate, samplesPerBlock);
-	lowPassTwo.prepare(spec);
-}
-
-void PluginProcessor::releaseResources() { }
+	lastBlockSize = samplesPerBlock;
+	// the conversion buffer is only needed when float buffers are run with
+	// double state, and is sized here so processBlock never allocates
+	doubleStateActive = useDoubleState && !isUsingDoublePrecision()
+		&& samplesPerBlock > 0;
+	if (doubleStateActive)
+		doubleBuffer.setSize(2, samplesPerBlock);
+	else
+		doubleBuffer.setSize(0, 0);
+	gainOne.reset(sampleRate);
+	gainTwo.reset(sampleRate);
+	highPassOne.reset(sampleRate);
+	highPassTwo.reset(sampleRate);
+	peakOne.reset(sampleRate);
+	peakTwo.reset(sampleRate);
+	peakThree.reset(sampleRate);
+	peakFour.reset(sampleRate);
+	peakFive.reset(sampleRate);
+	peakSix.reset(sampleRate);
+	lowPassOne.reset(sampleRate);
+	lowPassTwo.reset(sampleRate);
+	// the first block applies every value without smoothing and the mode
+	// without a fade, so nothing carries over from before the restart. a
+	// render starts the same whatever was processed ahead of it
+	gainOne.applyAllOnNextBlock();
+	gainTwo.applyAllOnNextBlock();
+	highPassOne.applyAllOnNextBlock();
+	highPassTwo.applyAllOnNextBlock();
+	peakOne.applyAllOnNextBlock();
+	peakTwo.applyAllOnNextBlock();
+	peakThree.applyAllOnNextBlock();
+	peakFour.applyAllOnNextBlock();
+	peakFive.applyAllOnNextBlock();
+	peakSix.applyAllOnNextBlock();
+	lowPassOne.applyAllOnNextBlock();
+	lowPassTwo.applyAllOnNextBlock();
+	midSideActive = isMidSide();
+	modeFadeSamples = -1;
+	heartbeat.reset();
+	processedSincePrepare = false;
+	// scheduled positions restart with the transport
+	automation.clear();
+	samplePosition = 0;
+	silentSamples = 0;
+	updateStages();
+}
+
+void PluginProcessor::releaseResources()
+{
+	processedSincePrepare = false;
+}
 
 void PluginProcessor::processBlock
 (juce::AudioBuffer<float> &buffer, juce::MidiBuffer &midiMessages)
 {
 	juce::ignoreUnused(midiMessages);
-	auto numInputChannels = getTotalNumInputChannels();
-	auto numOutputChannels = getTotalNumOutputChannels();
-	if (numOutputChannels < 2)
+	if (!doubleStateActive)
 	{
+		processBuffer(buffer);
 		return;
 	}
-	// zeroes out any unused outputs (if there are any)
-	for (auto i = numInputChannels; i < numOutputChannels; i++)
-		buffer.clear(i, 0, buffer.getNumSamples());
-	// process the audio
-	float* left = buffer.getWritePointer(0);
-	float* right = buffer.getWritePointer(1);
-	size_t length = (size_t) buffer.getNumSamples();
-	for (size_t i = 0;i < length;i++)
+	// blocks larger than prepared go through the conversion buffer a
+	// prepared block at a time, so the double sections never hand over to
+	// the stale float ones
+	int channels = std::min(buffer.getNumChannels(), 2);
+	int total = buffer.getNumSamples();
+	for (int start = 0;start < total;start += lastBlockSize)
 	{
-		float sampleOne;
-		float sampleTwo;
-		if (isMidSide())
+		int length = std::min(lastBlockSize, total - start);
+		doubleBuffer.setSize(2, length, false, false, true);
+		doubleBuffer.clear();
+		for (int c = 0;c < channels;c++)
 		{
-			sampleOne = (left[i] + right[i]) / 2;
-			sampleTwo = (left[i] - right[i]) / 2;
+			const float* source = buffer.getReadPointer(c, start);
+			double* dest = doubleBuffer.getWritePointer(c);
+			for (int i = 0;i < length;i++)
+				dest[i] = (double) source[i];
 		}
-		else
+		processBuffer(doubleBuffer);
+		for (int c = 0;c < channels;c++)
 		{
-			sampleOne = left[i];
-			sampleTwo = right[i];
-		}
-		sampleOne = processSampleChannelOne(sampleOne);
-		sampleTwo = processSampleChannelTwo(sampleTwo);
-		if (isMidSide())
-		{
-			left[i] = clampWithinOne(sampleOne + sampleTwo);
-			right[i] = clampWithinOne(sampleOne - sampleTwo);
-		}
-		else
-		{
-			left[i] = sampleOne;
-			right[i] = sampleTwo;
+			const double* source = doubleBuffer.getReadPointer(c);
+			float* dest = buffer.getWritePointer(c, start);
+			for (int i = 0;i < length;i++)
+				dest[i] = (float) source[i];
 		}
 	}
 }
 
+void PluginProcessor::processBlock
+(juce::AudioBuffer<double> &buffer, juce::MidiBuffer &midiMessages)
+{
+	juce::ignoreUnused(midiMessages);
+	processBuffer(buffer);
+}
+
+void PluginProcessor::setCoefficientUpdateInterval(int numSamples)
+{
+	highPassOne.setCoefficientUpdateInterval(numSamples);
+	highPassTwo.setCoefficientUpdateInterval(numSamples);
+	peakOne.setCoefficientUpdateInterval(numSamples);
+	peakTwo.setCoefficientUpdateInterval(numSamples);
+	peakThree.setCoefficientUpdateInterval(numSamples);
+	peakFour.setCoefficientUpdateInterval(numSamples);
+	peakFive.setCoefficientUpdateInterval(numSamples);
+	peakSix.setCoefficientUpdateInterval(numSamples);
+	lowPassOne.setCoefficientUpdateInterval(numSamples);
+	lowPassTwo.setCoefficientUpdateInterval(numSamples);
+}
+
+void PluginProcessor::setDoublePrecisionState(bool shouldUseDouble)
+{
+	useDoubleState = shouldUseDouble;
+}
+
+bool PluginProcessor::scheduleParameterChange
+(juce::AudioProcessorParameter* parameter, float normalisedValue,
+juce::int64 position)
+{
+	return automation.push({ position, parameter, normalisedValue });
+}
+
+// === Transactions ===========================================================
+void PluginProcessor::beginTransaction(const juce::String& name)
+{
+	undoManager.beginNewTransaction(name);
+	transaction.clear();
+}
+
+void PluginProcessor::setInTransaction
+(juce::RangedAudioParameter* param, float normalisedValue)
+{
+	// values the parameter already has are left out, so the host only
+	// records the parameters that moved
+	float value = param->convertTo0to1(
+		param->convertFrom0to1(normalisedValue)
+	);
+	if (std::bit_cast<uint32_t>(value)
+		!= std::bit_cast<uint32_t>(param->getValue()))
+		transaction.push_back({ param, value });
+}
+
+void PluginProcessor::endTransaction()
+{
+	if (transaction.empty())
+		return;
+	for (auto& [param, value] : transaction)
+		param->beginChangeGesture();
+	for (auto& [param, value] : transaction)
+		param->setValueNotifyingHost(value);
+	for (auto& [param, value] : transaction)
+		param->endChangeGesture();
+	transaction.clear();
+	notifyHostOfStateChange();
+}
+
 // === Factory Functions ======================================================
 juce::AudioProcessor *JUCE_CALLTYPE createPluginFilter()
 {
@@ -238,12 +353,13 @@ juce::AudioProcessorEditor *PluginProcessor::createEditor()
 #pragma GCC diagnostic ignored "-Wfloat-equal"
 bool PluginProcessor::isMidSide()
 {
-	return *tree.getRawParameterValue("mode") == 0;
+	return modeParameter->load() == 0;
 }
 #pragma GCC diagnostic pop
 
 void PluginProcessor::resetAllParams()
 {
+	beginTransaction("Reset");
 	resetFilterParams(&gainOne);
 	resetFilterParams(&gainTwo);
 	resetFilterParams(&highPassOne);
@@ -256,20 +372,44 @@ void PluginProcessor::resetAllParams()
 	resetFilterParams(&peakSix);
 	resetFilterParams(&lowPassOne);
 	resetFilterParams(&lowPassTwo);
+	endTransaction();
+}
+
+void PluginProcessor::setAllLinked(bool linked)
+{
+	beginTransaction(linked ? "Link All" : "Unlink All");
+	for (const FilterLink& link : filterLinks)
+		setInTransaction(tree.getParameter(link.id), linked ? 1.0f : 0.0f);
+	endTransaction();
 }
 
 void PluginProcessor::getStateInformation(juce::MemoryBlock &destData)
 {
-	auto state = tree.copyState();
-	std::unique_ptr<juce::XmlElement> xml(state.createXml());
-	copyXmlToBinary(*xml, destData);
+	binaryState.write(destData);
 }
 
 void PluginProcessor::setStateInformation(const void *data, int sizeInBytes)
 {
+	restoreState(data, sizeInBytes);
+}
+
+bool PluginProcessor::restoreState(const void* data, int sizeInBytes)
+{
+	if (BinaryState::isBinaryState(data, (size_t) sizeInBytes))
+	{
+		if (!binaryState.read(data, (size_t) sizeInBytes))
+			return false;
+		// the load is announced as new values, not a new parameter layout,
+		// and undo starts afresh as it does when the tree is replaced
+		undoManager.clearUndoHistory();
+		updateHostDisplay(ChangeDetails().withProgramChanged(true));
+		return true;
+	}
 	std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
-	if (xml.get() != nullptr && xml->hasTagName(tree.state.getType()))
-		tree.replaceState(juce::ValueTree::fromXml(*xml));
+	if (xml.get() == nullptr || !xml->hasTagName(tree.state.getType()))
+		return false;
+	tree.replaceState(juce::ValueTree::fromXml(*xml));
+	return true;
 }
 
 void PluginProcessor::notifyHostOfStateChange()
@@ -278,26 +418,358 @@ void PluginProcessor::notifyHostOfStateChange()
 }
 
 // === Other Private Helper ===================================================
-float PluginProcessor::processSampleChannelOne(float sample)
+void PluginProcessor::applyPendingParameters(bool smooth)
 {
-	sample = gainOne.processSample(sample);
-	sample = highPassOne.processSample(sample);
-	sample = peakOne.processSample(sample);
-	sample = peakThree.processSample(sample);
-	sample = peakFive.processSample(sample);
-	sample = lowPassOne.processSample(sample);
-	return sample;
+	gainOne.applyPendingParameters(smooth);
+	gainTwo.applyPendingParameters(smooth);
+	highPassOne.applyPendingParameters(smooth);
+	highPassTwo.applyPendingParameters(smooth);
+	peakOne.applyPendingParameters(smooth);
+	peakTwo.applyPendingParameters(smooth);
+	peakThree.applyPendingParameters(smooth);
+	peakFour.applyPendingParameters(smooth);
+	peakFive.applyPendingParameters(smooth);
+	peakSix.applyPendingParameters(smooth);
+	lowPassOne.applyPendingParameters(smooth);
+	lowPassTwo.applyPendingParameters(smooth);
 }
 
-float PluginProcessor::processSampleChannelTwo(float sample)
+// sets the parameters as a host delivering automation on the audio thread
+// would, then has the filters pick the new values up straight away
+bool PluginProcessor::applyDueAutomation(juce::int64 position, bool smooth)
 {
-	sample = gainTwo.processSample(sample);
-	sample = highPassTwo.processSample(sample);
-	sample = peakTwo.processSample(sample);
-	sample = peakFour.processSample(sample);
-	sample = peakSix.processSample(sample);
-	sample = lowPassTwo.processSample(sample);
-	return sample;
+	AutomationQueue::Change change;
+	bool applied = false;
+	while (automation.popDue(position, change))
+	{
+		change.parameter->setValue(change.normalisedValue);
+		applied = true;
+	}
+	if (applied)
+		applyPendingParameters(smooth);
+	return applied;
+}
+
+template <typename SampleType>
+void PluginProcessor::processBuffer(juce::AudioBuffer<SampleType>& buffer)
+{
+	// changes made before the first block since prepareToPlay are applied
+	// without smoothing. the heartbeat is only published for other threads,
+	// as a stalled render thread would otherwise change the output
+	bool wasProcessing = processedSincePrepare;
+	processedSincePrepare = true;
+	heartbeat.beat(buffer.getNumSamples(), lastSampleRate);
+	applyPendingParameters(wasProcessing);
+	auto numInputChannels = getTotalNumInputChannels();
+	auto numOutputChannels = getTotalNumOutputChannels();
+	if (numOutputChannels < 2)
+	{
+		return;
+	}
+	// zeroes out any unused outputs (if there are any)
+	for (auto i = numInputChannels; i < numOutputChannels; i++)
+		buffer.clear(i, 0, buffer.getNumSamples());
+	// process the audio
+	SampleType* left = buffer.getWritePointer(0);
+	SampleType* right = buffer.getWritePointer(1);
+	size_t length = (size_t) buffer.getNumSamples();
+	updateChannelMode(wasProcessing);
+	updateStages();
+	// silence in after the tail has rung out is silence out, so the block
+	// is left as it is. changes are still applied, to be picked up on waking.
+	// silence only counts once every stage is steady, as a ramp or fade
+	// changes what rings and for how long
+	bool silent = isSilent(left, length) && isSilent(right, length);
+	bool counting = silent && stagesSteady && modeFadeSamples < 0;
+	bool asleep = counting && (double) silentSamples >= tailSamples;
+	silentSamples = counting ? silentSamples + (juce::int64) length : 0;
+	// the block is split wherever a scheduled change falls, so automation
+	// lands on its sample whatever the host's buffer size
+	size_t start = 0;
+	while (start < length)
+	{
+		juce::int64 position = samplePosition + (juce::int64) start;
+		if (applyDueAutomation(position, wasProcessing))
+			updateChannelMode(wasProcessing);
+		size_t end = length;
+		juce::int64 next = 0;
+		if (automation.getNextPosition(next)
+			&& next < samplePosition + (juce::int64) length)
+			end = (size_t) (next - samplePosition);
+		if (!asleep)
+			processSegment(left + start, right + start, end - start);
+		start = end;
+	}
+	samplePosition += (juce::int64) length;
+}
+
+template <typename SampleType>
+void PluginProcessor::processSegment
+(SampleType* left, SampleType* right, size_t length)
+{
+	size_t start = 0;
+	while (start < length)
+	{
+		// a chunk never runs past the point where the channel mode flips
+		size_t chunk = length - start;
+		if (modeFadeSamples >= 0 && modeFadeSamples < modeFadeLength)
+		{
+			size_t untilFlip = (size_t) (modeFadeLength - modeFadeSamples);
+			chunk = std::min(chunk, untilFlip);
+		}
+		processChannels(left + start, right + start, chunk);
+		applyModeFade(left + start, right + start, chunk);
+		advanceSmoothers(chunk);
+		start += chunk;
+	}
+}
+
+template <typename SampleType>
+void PluginProcessor::processChannels
+(SampleType* left, SampleType* right, size_t numSamples)
+{
+	ChannelState<SampleType>& state = getChannelState<SampleType>();
+	updateStages();
+	bool fusedOne = gatherCascade(stagesOne, state.cascadeOne);
+	bool fusedTwo = gatherCascade(stagesTwo, state.cascadeTwo);
+	// a steady gain rides along in the first section of a fused cascade,
+	// so it costs no pass over the block of its own
+	bool foldedOne = fusedOne && gainOne.foldInto(state.cascadeOne);
+	bool foldedTwo = fusedTwo && gainTwo.foldInto(state.cascadeTwo);
+	// a channel whose settled response is flat is not processed. in stereo
+	// mode with both flat the block is left untouched, while in m/s mode
+	// the matrix still runs, as decoding clips the output
+	bool flatOne = foldedOne && state.cascadeOne.isIdentity();
+	bool flatTwo = foldedTwo && state.cascadeTwo.isIdentity();
+	if (flatOne && flatTwo && !midSideActive)
+		return;
+	if (midSideActive)
+		encodeMidSide(left, right, numSamples);
+	if (!foldedOne)
+		gainOne.processBlock(left, numSamples);
+	if (!foldedTwo)
+		gainTwo.processBlock(right, numSamples);
+	if (fusedOne && fusedTwo && !flatOne && !flatTwo)
+	{
+		state.dualCascade.processBlock(
+			state.cascadeOne, left, state.cascadeTwo, right, numSamples
+		);
+	}
+	else
+	{
+		if (!fusedOne)
+			processStages(stagesOne, left, numSamples);
+		else if (!flatOne)
+			state.cascadeOne.processBlock(left, numSamples);
+		if (!fusedTwo)
+			processStages(stagesTwo, right, numSamples);
+		else if (!flatTwo)
+			state.cascadeTwo.processBlock(right, numSamples);
+	}
+	if (midSideActive)
+		decodeMidSide(left, right, numSamples);
+}
+
+template <typename SampleType>
+void PluginProcessor::encodeMidSide
+(SampleType* left, SampleType* right, size_t numSamples)
+{
+	auto& matrixBuffer = getChannelState<SampleType>().matrixBuffer;
+	SampleType* side = matrixBuffer.data();
+	SampleType half = (SampleType) 0.5;
+	size_t start = 0;
+	while (start < numSamples)
+	{
+		int n = (int) std::min(numSamples - start, matrixBuffer.size());
+		SampleType* l = left + start;
+		SampleType* r = right + start;
+		juce::FloatVectorOperations::subtract(side, l, r, n);
+		juce::FloatVectorOperations::add(l, r, n);
+		juce::FloatVectorOperations::multiply(l, half, n);
+		juce::FloatVectorOperations::copyWithMultiply(r, side, half, n);
+		start += (size_t) n;
+	}
+}
+
+template <typename SampleType>
+void PluginProcessor::decodeMidSide
+(SampleType* left, SampleType* right, size_t numSamples)
+{
+	auto& matrixBuffer = getChannelState<SampleType>().matrixBuffer;
+	SampleType* difference = matrixBuffer.data();
+	SampleType one = 1;
+	size_t start = 0;
+	while (start < numSamples)
+	{
+		int n = (int) std::min(numSamples - start, matrixBuffer.size());
+		SampleType* mid = left + start;
+		SampleType* side = right + start;
+		juce::FloatVectorOperations::subtract(difference, mid, side, n);
+		juce::FloatVectorOperations::add(mid, side, n);
+		juce::FloatVectorOperations::clip(mid, mid, -one, one, n);
+		juce::FloatVectorOperations::clip(side, difference, -one, one, n);
+		start += (size_t) n;
+	}
+}
+
+void PluginProcessor::updateChannelMode(bool wasProcessing)
+{
+	bool midSide = isMidSide();
+	if (!wasProcessing)
+	{
+		// nothing is playing, so there is nothing to fade
+		midSideActive = midSide;
+		modeFadeSamples = -1;
+	}
+	else if (modeFadeSamples < 0)
+	{
+		if (midSide != midSideActive)
+			modeFadeSamples = 0;
+	}
+	else if (modeFadeSamples < modeFadeLength)
+	{
+		// switched back before the mode flipped, so just fade back in
+		if (midSide == midSideActive)
+			modeFadeSamples = (2 * modeFadeLength) - modeFadeSamples;
+	}
+	else if (midSide != midSideActive)
+	{
+		// switched again while fading in, so fade back out
+		if (modeFadeSamples == modeFadeLength)
+			midSideActive = midSide;
+		else
+			modeFadeSamples = (2 * modeFadeLength) - modeFadeSamples;
+	}
+}
+
+template <typename SampleType>
+void PluginProcessor::applyModeFade
+(SampleType* left, SampleType* right, size_t numSamples)
+{
+	// fades out, flips the mode while silent, then fades back in. the chain
+	// only runs in one domain at a time, so this is the same dip used when a
+	// cut filter changes order rather than a crossfade between two chains
+	for (size_t i = 0;i < numSamples && modeFadeSamples >= 0;i++)
+	{
+		float gain = std::abs((float) modeFadeSamples - modeFadeLength)
+			/ modeFadeLength;
+		left[i] *= gain;
+		right[i] *= gain;
+		modeFadeSamples++;
+		if (modeFadeSamples == modeFadeLength)
+			midSideActive = !midSideActive;
+		else if (modeFadeSamples >= modeFadeLength * 2)
+			modeFadeSamples = -1;
+	}
+}
+
+// every ramp moves on together once the filters have run over the block,
+// and only the filters whose values moved hear about it
+void PluginProcessor::advanceSmoothers(size_t numSamples)
+{
+	uint64_t moved = smoothers.advance((int) numSamples);
+	if (moved == 0)
+		return;
+	gainOne.onSmoothersAdvanced(moved);
+	gainTwo.onSmoothersAdvanced(moved);
+	highPassOne.onSmoothersAdvanced(moved);
+	highPassTwo.onSmoothersAdvanced(moved);
+	peakOne.onSmoothersAdvanced(moved);
+	peakTwo.onSmoothersAdvanced(moved);
+	peakThree.onSmoothersAdvanced(moved);
+	peakFour.onSmoothersAdvanced(moved);
+	peakFive.onSmoothersAdvanced(moved);
+	peakSix.onSmoothersAdvanced(moved);
+	lowPassOne.onSmoothersAdvanced(moved);
+	lowPassTwo.onSmoothersAdvanced(moved);
+}
+
+// the stages are settled once per block, and again for each part of a
+// split block, so the tail always follows the current settings
+void PluginProcessor::updateStages()
+{
+	updateActiveStages(stagesOne);
+	updateActiveStages(stagesTwo);
+	updateTail();
+}
+
+void PluginProcessor::updateActiveStages(ChannelStages& stages)
+{
+	bool changed = stages.fading;
+	for (CtmFilter* filter : stages.filters)
+		changed = filter->takeStageChange() || changed;
+	if (!changed)
+		return;
+	stages.numActive = 0;
+	stages.fading = false;
+	for (CtmFilter* filter : stages.filters)
+	{
+		if (!filter->isActive())
+			continue;
+		stages.active[stages.numActive++] = filter;
+		// faded filters stay listed and crossfade until the fade ends
+		stages.fading = stages.fading || filter->isBypassFading();
+	}
+}
+
+void PluginProcessor::updateTail()
+{
+	// ringing falls by the pole radius every sample. bypassed filters are
+	// not listed, so they add nothing to the tail
+	double radius = 0;
+	stagesSteady = true;
+	for (const ChannelStages* stages : { &stagesOne, &stagesTwo })
+	{
+		for (size_t i = 0;i < stages->numActive;i++)
+		{
+			CtmFilter* filter = stages->active[i];
+			radius = std::max(radius, filter->getPoleRadius());
+			stagesSteady = stagesSteady && filter->isSteady();
+		}
+	}
+	double samples = 0;
+	if (radius >= 1)
+		samples = std::numeric_limits<double>::infinity();
+	else if (radius > 0)
+		samples = std::log(tailDecayLevel) / std::log(radius);
+	tailSamples = samples;
+	tailSeconds.store(samples / lastSampleRate);
+}
+
+template <typename SampleType>
+bool PluginProcessor::isSilent(const SampleType* data, size_t numSamples)
+{
+	for (size_t i = 0;i < numSamples;i++)
+	{
+		if (data[i] < 0 || data[i] > 0)
+			return false;
+	}
+	return true;
+}
+
+template <typename SampleType>
+bool PluginProcessor::gatherCascade
+(const ChannelStages& stages, BiquadCascade<SampleType>& cascade)
+{
+	for (size_t i = 0;i < stages.numActive;i++)
+	{
+		if (!stages.active[i]->isSteady())
+			return false;
+	}
+	// the section list is gathered every block so it always matches the
+	// current order and shelf settings
+	cascade.clear();
+	for (size_t i = 0;i < stages.numActive;i++)
+		stages.active[i]->addSections(cascade);
+	return true;
+}
+
+template <typename SampleType>
+void PluginProcessor::processStages
+(const ChannelStages& stages, SampleType* data, size_t numSamples)
+{
+	for (size_t i = 0;i < stages.numActive;i++)
+		stages.active[i]->processBlock(data, numSamples);
 }
 
 void PluginProcessor::resetFilterParams(CtmFilter* filter)
@@ -308,9 +780,7 @@ void PluginProcessor::resetFilterParams(CtmFilter* filter)
 	{
 		std::string name = filter->name + "-" + fields.idPostfix;
 		juce::RangedAudioParameter* param = tree.getParameter(name);
-		param->beginChangeGesture();
-		param->setValueNotifyingHost(param->getDefaultValue());
-		param->endChangeGesture();
+		setInTransaction(param, param->getDefaultValue());
 	}
 }
 
@@ -318,14 +788,4 @@ void PluginProcessor::addParameterListener(ParameterListener* listener)
 {
 	paramListeners.push_front(listener);
 	tree.addParameterListener(listener->parameter, listener);
-}
-
-float PluginProcessor::clampWithinOne(float f)
-{
-	if (f > 1)
-		return 1;
-	else if (f < -1)
-		return -1;
-	else
-		return f;
-}
+}
\ No newline at end of file
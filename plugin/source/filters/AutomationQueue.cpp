@@ -0,0 +1,40 @@
+#include "AutomationQueue.h"
+
+// === Lifecycle ==============================================================
+AutomationQueue::AutomationQueue() : fifo(capacity), changes() { }
+
+// === Scheduling Thread ======================================================
+bool AutomationQueue::push(const Change& change)
+{
+    if (fifo.getFreeSpace() < 1)
+        return false;
+    const auto scope = fifo.write(1);
+    changes[(size_t) scope.startIndex1] = change;
+    return true;
+}
+
+// === Audio Thread ===========================================================
+bool AutomationQueue::getNextPosition(juce::int64& position) const
+{
+    if (fifo.getNumReady() < 1)
+        return false;
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(1, start1, size1, start2, size2);
+    position = changes[(size_t) start1].samplePosition;
+    return true;
+}
+
+bool AutomationQueue::popDue(juce::int64 position, Change& change)
+{
+    juce::int64 next = 0;
+    if (!getNextPosition(next) || next > position)
+        return false;
+    const auto scope = fifo.read(1);
+    change = changes[(size_t) scope.startIndex1];
+    return true;
+}
+
+void AutomationQueue::clear()
+{
+    fifo.finishedRead(fifo.getNumReady());
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "BinaryState.h"
+#include <algorithm>
+#include <bit>
+
+// === Lifecycle ==============================================================
+BinaryState::BinaryState(juce::AudioProcessor& processor) : layout(hashSeed)
+{
+    for (juce::AudioProcessorParameter* param : processor.getParameters())
+    {
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(param);
+        if (ranged == nullptr)
+            continue;
+        std::string id = ranged->getParameterID().toStdString();
+        byId.push_back({ hash(hashSeed, id.c_str(), id.size()), ids.size() });
+        ids.push_back(byId.back().id);
+        parameters.push_back(ranged);
+        layout = hash(layout, id.c_str(), id.size() + 1);
+    }
+    std::sort(byId.begin(), byId.end(),
+        [](const IdEntry& a, const IdEntry& b) { return a.id < b.id; });
+    // two ids sharing a hash would have their values swapped on loading
+    jassert(std::adjacent_find(byId.begin(), byId.end(),
+        [](const IdEntry& a, const IdEntry& b) { return a.id == b.id; })
+        == byId.end());
+}
+
+// === Any Thread =============================================================
+void BinaryState::write(juce::MemoryBlock& destData) const
+{
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt((int) magic);
+    stream.writeShort((short) version);
+    stream.writeShort((short) parameters.size());
+    for (size_t i = 0;i < parameters.size();i++)
+    {
+        juce::RangedAudioParameter* param = parameters[i];
+        stream.writeInt((int) ids[i]);
+        stream.writeFloat(param->convertFrom0to1(param->getValue()));
+    }
+    juce::uint32 checksum = hash(
+        hashSeed, stream.getData(), stream.getDataSize()
+    );
+    stream.writeInt((int) checksum);
+}
+
+bool BinaryState::isBinaryState(const void* data, size_t size)
+{
+    return size >= headerSize
+        && juce::ByteOrder::littleEndianInt(data) == magic;
+}
+
+// === Message Thread =========================================================
+bool BinaryState::read(const void* data, size_t size) const
+{
+    if (!isBinaryState(data, size) || size < headerSize + checksumSize)
+        return false;
+    size_t checked = size - checksumSize;
+    auto* checksum = static_cast<const char*>(data) + checked;
+    if (juce::ByteOrder::littleEndianInt(checksum)
+        != hash(hashSeed, data, checked))
+        return false;
+    juce::MemoryInputStream stream(data, checked, false);
+    stream.skipNextBytes(4);
+    auto dataVersion = (juce::uint16) stream.readShort();
+    auto count = (size_t) (juce::uint16) stream.readShort();
+    Values values(parameters.size());
+    bool valid = false;
+    if (dataVersion == 1)
+        valid = readVersionOne(stream, count, checked, values);
+    else if (dataVersion == version)
+        valid = readVersionTwo(stream, count, checked, values);
+    if (!valid)
+        return false;
+    std::vector<juce::RangedAudioParameter*> changed;
+    for (size_t i = 0;i < parameters.size();i++)
+    {
+        juce::RangedAudioParameter* param = parameters[i];
+        float normalised = values[i].has_value()
+            ? param->convertTo0to1(*values[i])
+            : param->getDefaultValue();
+        if (std::bit_cast<juce::uint32>(normalised)
+            != std::bit_cast<juce::uint32>(param->getValue()))
+        {
+            param->setValue(normalised);
+            changed.push_back(param);
+        }
+    }
+    // setValue alone only reaches the tree. attachments, wrappers and other
+    // listeners hear about the parameters that actually changed, once all
+    // of them hold their new values
+    for (juce::RangedAudioParameter* param : changed)
+        param->sendValueChangedMessageToListeners(param->getValue());
+    return true;
+}
+
+// === Private Helper =========================================================
+// version 1 kept no ids, only the fingerprint of the layout it was written
+// with. it was only ever written with the current layout, so its values are
+// placed by position once the fingerprint matches
+bool BinaryState::readVersionOne
+(juce::MemoryInputStream& stream, size_t count, size_t size,
+Values& values) const
+{
+    if (size != headerSize + layoutSize + (count * sizeof(float))
+        || count != parameters.size()
+        || (juce::uint32) stream.readInt() != layout)
+        return false;
+    for (size_t i = 0;i < count;i++)
+        values[i] = stream.readFloat();
+    return true;
+}
+
+bool BinaryState::readVersionTwo
+(juce::MemoryInputStream& stream, size_t count, size_t size,
+Values& values) const
+{
+    if (size != headerSize + (count * entrySize))
+        return false;
+    for (size_t i = 0;i < count;i++)
+    {
+        auto id = (juce::uint32) stream.readInt();
+        float value = stream.readFloat();
+        auto found = std::lower_bound(byId.begin(), byId.end(), id,
+            [](const IdEntry& entry, juce::uint32 v) { return entry.id < v; });
+        if (found != byId.end() && found->id == id)
+            values[found->index] = value;
+    }
+    return true;
+}
+
+// fnv-1a, which is plenty to catch truncated or corrupted state and to tell
+// parameter ids apart
+juce::uint32 BinaryState::hash
+(juce::uint32 seed, const void* data, size_t size)
+{
+    auto* bytes = static_cast<const juce::uint8*>(data);
+    juce::uint32 result = seed;
+    for (size_t i = 0;i < size;i++)
+    {
+        result ^= bytes[i];
+        result *= hashPrime;
+    }
+    return result;
+}
\ No newline at end of file
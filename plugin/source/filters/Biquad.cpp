@@ -0,0 +1,305 @@
+#include "Biquad.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <numbers>
+
+// === Factory Functions ======================================================
+BiquadCoefficients BiquadCoefficients::makeIdentity()
+{
+    return { 1, 0, 0, 0, 0 };
+}
+
+BiquadCoefficients BiquadCoefficients::makeHighPass
+(double sampleRate, float frequency, float q)
+{
+    double n = 1 / std::tan(std::numbers::pi * frequency / sampleRate);
+    double nSquared = n * n;
+    double invQ = 1 / (double) q;
+    double c1 = 1 / (1 + (invQ * n) + nSquared);
+    return {
+        (c1 * nSquared),
+        (-2 * c1 * nSquared),
+        (c1 * nSquared),
+        (c1 * 2 * (1 - nSquared)),
+        (c1 * (1 - (invQ * n) + nSquared))
+    };
+}
+
+BiquadCoefficients BiquadCoefficients::makeLowPass
+(double sampleRate, float frequency, float q)
+{
+    double n = 1 / std::tan(std::numbers::pi * frequency / sampleRate);
+    double nSquared = n * n;
+    double invQ = 1 / (double) q;
+    double c1 = 1 / (1 + (invQ * n) + nSquared);
+    return {
+        c1,
+        (c1 * 2),
+        c1,
+        (c1 * 2 * (1 - nSquared)),
+        (c1 * (1 - (invQ * n) + nSquared))
+    };
+}
+
+BiquadCoefficients BiquadCoefficients::makeFirstOrderHighPass
+(double sampleRate, float frequency)
+{
+    double n = std::tan(std::numbers::pi * frequency / sampleRate);
+    double a0 = n + 1;
+    return {
+        (1 / a0), (-1 / a0), 0, ((n - 1) / a0), 0
+    };
+}
+
+BiquadCoefficients BiquadCoefficients::makeFirstOrderLowPass
+(double sampleRate, float frequency)
+{
+    double n = std::tan(std::numbers::pi * frequency / sampleRate);
+    double a0 = n + 1;
+    return {
+        (n / a0), (n / a0), 0, ((n - 1) / a0), 0
+    };
+}
+
+BiquadCoefficients BiquadCoefficients::makeLowShelf
+(double sampleRate, float frequency, float q, float gain)
+{
+    double a = std::sqrt(std::max(0.0, (double) gain));
+    double aMinusOne = a - 1;
+    double aPlusOne = a + 1;
+    double omega = (2 * std::numbers::pi * frequency) / sampleRate;
+    double cosOmega = std::cos(omega);
+    double beta = std::sin(omega) * std::sqrt(a) / q;
+    double aMinusOneTimesCos = aMinusOne * cosOmega;
+    double a0 = aPlusOne + aMinusOneTimesCos + beta;
+    return {
+        (a * (aPlusOne - aMinusOneTimesCos + beta) / a0),
+        (a * 2 * (aMinusOne - (aPlusOne * cosOmega)) / a0),
+        (a * (aPlusOne - aMinusOneTimesCos - beta) / a0),
+        (-2 * (aMinusOne + (aPlusOne * cosOmega)) / a0),
+        ((aPlusOne + aMinusOneTimesCos - beta) / a0)
+    };
+}
+
+BiquadCoefficients BiquadCoefficients::makeHighShelf
+(double sampleRate, float frequency, float q, float gain)
+{
+    double a = std::sqrt(std::max(0.0, (double) gain));
+    double aMinusOne = a - 1;
+    double aPlusOne = a + 1;
+    double omega = (2 * std::numbers::pi * frequency) / sampleRate;
+    double cosOmega = std::cos(omega);
+    double beta = std::sin(omega) * std::sqrt(a) / q;
+    double aMinusOneTimesCos = aMinusOne * cosOmega;
+    double a0 = aPlusOne - aMinusOneTimesCos + beta;
+    return {
+        (a * (aPlusOne + aMinusOneTimesCos + beta) / a0),
+        (a * -2 * (aMinusOne + (aPlusOne * cosOmega)) / a0),
+        (a * (aPlusOne + aMinusOneTimesCos - beta) / a0),
+        (2 * (aMinusOne - (aPlusOne * cosOmega)) / a0),
+        ((aPlusOne - aMinusOneTimesCos - beta) / a0)
+    };
+}
+
+BiquadCoefficients BiquadCoefficients::makePeakFilter
+(double sampleRate, float frequency, float q, float gain)
+{
+    double a = std::sqrt(std::max(0.0, (double) gain));
+    double omega = (2 * std::numbers::pi * frequency) / sampleRate;
+    double alpha = std::sin(omega) / (q * 2.0);
+    double c2 = -2 * std::cos(omega);
+    double alphaTimesA = alpha * a;
+    double alphaOverA = alpha / a;
+    double a0 = 1 + alphaOverA;
+    return {
+        ((1 + alphaTimesA) / a0),
+        (c2 / a0),
+        ((1 - alphaTimesA) / a0),
+        (c2 / a0),
+        ((1 - alphaOverA) / a0)
+    };
+}
+
+// === Frequency Response =====================================================
+double BiquadCoefficients::getMagnitudeForFrequency
+(double frequency, double sampleRate) const
+{
+    double omega = (-2 * std::numbers::pi * frequency) / sampleRate;
+    std::complex<double> z1 = std::polar(1.0, omega);
+    std::complex<double> z2 = std::polar(1.0, 2 * omega);
+    std::complex<double> numerator = b0 + (b1 * z1) + (b2 * z2);
+    std::complex<double> denominator = 1.0 + (a1 * z1) + (a2 * z2);
+    return std::abs(numerator / denominator);
+}
+
+void BiquadCoefficients::getMagnitudeForFrequencyArray
+(const double* frequencies, double* magnitudes, size_t len, double sampleRate)
+const
+{
+    for (size_t i = 0;i < len;i++)
+        magnitudes[i] = getMagnitudeForFrequency(frequencies[i], sampleRate);
+}
+
+// === Lifecycle ==============================================================
+template <typename SampleType>
+Biquad<SampleType>::Biquad()
+    : coefficients({ 1, 0, 0, 0, 0 }), target({ 1, 0, 0, 0, 0 }),
+    increment({ 0, 0, 0, 0, 0 }), rampRemaining(0), state1(0), state2(0)
+{ }
+
+// === Coefficients ===========================================================
+template <typename SampleType>
+void Biquad<SampleType>::setCoefficients
+(const BiquadCoefficients& newCoefficients, int rampLength)
+{
+    target = {
+        (SampleType) newCoefficients.b0,
+        (SampleType) newCoefficients.b1,
+        (SampleType) newCoefficients.b2,
+        (SampleType) newCoefficients.a1,
+        (SampleType) newCoefficients.a2
+    };
+    if (rampLength <= 0)
+    {
+        coefficients = target;
+        rampRemaining = 0;
+        return;
+    }
+    SampleType step = 1 / (SampleType) rampLength;
+    increment.b0 = (target.b0 - coefficients.b0) * step;
+    increment.b1 = (target.b1 - coefficients.b1) * step;
+    increment.b2 = (target.b2 - coefficients.b2) * step;
+    increment.a1 = (target.a1 - coefficients.a1) * step;
+    increment.a2 = (target.a2 - coefficients.a2) * step;
+    rampRemaining = rampLength;
+}
+
+template <typename SampleType>
+bool Biquad<SampleType>::isIdentity() const
+{
+    if (isRamping() || !isNearZero(state1) || !isNearZero(state2))
+        return false;
+    // zeros that cancel the poles, which a peak or shelf at 0 dB designs
+    return isNearZero(coefficients.b0 - 1)
+        && isNearZero(coefficients.b1 - coefficients.a1)
+        && isNearZero(coefficients.b2 - coefficients.a2);
+}
+
+template <typename SampleType>
+double Biquad<SampleType>::getPoleRadius() const
+{
+    double radius = getPoleRadius(coefficients.a1, coefficients.a2);
+    if (isRamping())
+        radius = std::max(radius, getPoleRadius(target.a1, target.a2));
+    return radius;
+}
+
+// === Process Audio ==========================================================
+template <typename SampleType>
+void Biquad<SampleType>::reset()
+{
+    coefficients = target;
+    rampRemaining = 0;
+    state1 = 0;
+    state2 = 0;
+}
+
+template <typename SampleType>
+void Biquad<SampleType>::processBlock(SampleType* data, size_t numSamples)
+{
+    // copy everything into locals so the compiler can keep them in registers
+    SampleType b0 = coefficients.b0;
+    SampleType b1 = coefficients.b1;
+    SampleType b2 = coefficients.b2;
+    SampleType a1 = coefficients.a1;
+    SampleType a2 = coefficients.a2;
+    SampleType s1 = state1;
+    SampleType s2 = state2;
+    size_t i = 0;
+    if (rampRemaining > 0)
+    {
+        size_t rampSamples = std::min(numSamples, (size_t) rampRemaining);
+        for (;i < rampSamples;i++)
+        {
+            b0 += increment.b0;
+            b1 += increment.b1;
+            b2 += increment.b2;
+            a1 += increment.a1;
+            a2 += increment.a2;
+            SampleType input = data[i];
+            SampleType output = (input * b0) + s1;
+            s1 = (input * b1) - (output * a1) + s2;
+            s2 = (input * b2) - (output * a2);
+            data[i] = output;
+        }
+        rampRemaining -= (int) rampSamples;
+        if (rampRemaining == 0)
+        {
+            // land exactly on the target to avoid accumulating rounding error
+            b0 = target.b0;
+            b1 = target.b1;
+            b2 = target.b2;
+            a1 = target.a1;
+            a2 = target.a2;
+        }
+        coefficients = { b0, b1, b2, a1, a2 };
+    }
+    for (;i < numSamples;i++)
+    {
+        SampleType input = data[i];
+        SampleType output = (input * b0) + s1;
+        s1 = (input * b1) - (output * a1) + s2;
+        s2 = (input * b2) - (output * a2);
+        data[i] = output;
+    }
+    state1 = snapToZero(s1);
+    state2 = snapToZero(s2);
+}
+
+// === Private Helper =========================================================
+template <typename SampleType>
+void Biquad<SampleType>::advanceRamp()
+{
+    if (--rampRemaining == 0)
+    {
+        coefficients = target;
+        return;
+    }
+    coefficients.b0 += increment.b0;
+    coefficients.b1 += increment.b1;
+    coefficients.b2 += increment.b2;
+    coefficients.a1 += increment.a1;
+    coefficients.a2 += increment.a2;
+}
+
+template <typename SampleType>
+SampleType Biquad<SampleType>::snapToZero(SampleType value)
+{
+    if (isNearZero(value))
+        return 0;
+    return value;
+}
+
+template <typename SampleType>
+bool Biquad<SampleType>::isNearZero(SampleType value)
+{
+    return !(value < (SampleType) -1.0e-8 || value > (SampleType) 1.0e-8);
+}
+
+template <typename SampleType>
+double Biquad<SampleType>::getPoleRadius(SampleType a1Arg, SampleType a2Arg)
+{
+    // the poles are the roots of z^2 + a1 z + a2
+    double a1 = (double) a1Arg;
+    double a2 = (double) a2Arg;
+    double discriminant = (a1 * a1) - (4 * a2);
+    // a complex pair, whose radius squared is their product
+    if (discriminant < 0)
+        return std::sqrt(a2);
+    return (std::abs(a1) + std::sqrt(discriminant)) / 2;
+}
+
+// === Instantiations =========================================================
+template class Biquad<float>;
+template class Biquad<double>;
\ No newline at end of file
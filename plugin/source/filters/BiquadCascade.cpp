@@ -0,0 +1,110 @@
+#include "BiquadCascade.h"
+#include <cassert>
+
+// === Lifecycle ==============================================================
+template <typename SampleType>
+BiquadCascade<SampleType>::BiquadCascade()
+    : numSections(0), inputGain(1), hasInputGain(false)
+{ }
+
+// === Sections ===============================================================
+template <typename SampleType>
+void BiquadCascade<SampleType>::clear()
+{
+    numSections = 0;
+    inputGain = 1;
+    hasInputGain = false;
+}
+
+template <typename SampleType>
+void BiquadCascade<SampleType>::addSection(Biquad<SampleType>* section)
+{
+    assert(numSections < maxSections);
+    assert(!section->isRamping());
+    if (numSections < maxSections)
+        sections[numSections++] = section;
+}
+
+template <typename SampleType>
+void BiquadCascade<SampleType>::setInputGain(SampleType gain)
+{
+    inputGain = gain;
+    hasInputGain = true;
+}
+
+template <typename SampleType>
+bool BiquadCascade<SampleType>::isIdentity() const
+{
+    if (hasInputGain)
+        return false;
+    for (size_t s = 0;s < numSections;s++)
+    {
+        if (!sections[s]->isIdentity())
+            return false;
+    }
+    return true;
+}
+
+// === Process Audio ==========================================================
+template <typename SampleType>
+void BiquadCascade<SampleType>::processBlock
+(SampleType* data, size_t numSamples)
+{
+    size_t count = numSections;
+    if (count == 0)
+    {
+        applyInputGain(data, numSamples);
+        return;
+    }
+    // gather the sections into the contiguous arrays
+    for (size_t s = 0;s < count;s++)
+    {
+        const Biquad<SampleType>* section = sections[s];
+        b0[s] = section->coefficients.b0;
+        b1[s] = section->coefficients.b1;
+        b2[s] = section->coefficients.b2;
+        a1[s] = section->coefficients.a1;
+        a2[s] = section->coefficients.a2;
+        state1[s] = section->state1;
+        state2[s] = section->state2;
+    }
+    // scaling the feed forward coefficients scales the section's input, and
+    // leaves its state just as if the input had been scaled beforehand
+    b0[0] *= inputGain;
+    b1[0] *= inputGain;
+    b2[0] *= inputGain;
+    // run the whole chain one sample at a time
+    for (size_t i = 0;i < numSamples;i++)
+    {
+        SampleType sample = data[i];
+        for (size_t s = 0;s < count;s++)
+        {
+            SampleType output = (sample * b0[s]) + state1[s];
+            state1[s] = (sample * b1[s]) - (output * a1[s]) + state2[s];
+            state2[s] = (sample * b2[s]) - (output * a2[s]);
+            sample = output;
+        }
+        data[i] = sample;
+    }
+    // hand the state back so the sections can carry on by themselves
+    for (size_t s = 0;s < count;s++)
+    {
+        sections[s]->state1 = Biquad<SampleType>::snapToZero(state1[s]);
+        sections[s]->state2 = Biquad<SampleType>::snapToZero(state2[s]);
+    }
+}
+
+// === Private Helper =========================================================
+template <typename SampleType>
+void BiquadCascade<SampleType>::applyInputGain
+(SampleType* data, size_t numSamples)
+{
+    if (!hasInputGain)
+        return;
+    for (size_t i = 0;i < numSamples;i++)
+        data[i] *= inputGain;
+}
+
+// === Instantiations =========================================================
+template class BiquadCascade<float>;
+template class BiquadCascade<double>;
\ No newline at end of file
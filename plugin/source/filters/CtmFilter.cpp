@@ -1,49 +1,42 @@
 #include "CtmFilter.h"
-#include <chrono>
+#include <algorithm>
+#include <bit>
 #include <format>
 
 using Parameter = juce::AudioProcessorValueTreeState::Parameter;
 
 // === Lifecycle ==============================================================
 CtmFilter::CtmFilter
-(std::string nameArg, std::string parameterText, std::string secondText)
+(SmootherBank& bank, size_t numSmoothed, std::string nameArg,
+std::string parameterText, std::string secondText)
     : name(nameArg), paramText(parameterText), secondaryParamText(secondText),
-    timeAtLastProcess(0), stateTree(nullptr)
-{ }
-
-// === ValueTreeState Listener ================================================
-void CtmFilter::setListenTo(juce::AudioProcessorValueTreeState* tree)
+    coefficientUpdateInterval(defaultCoefficientUpdateInterval),
+    samplesUntilUpdate(0), smoothers(bank),
+    firstLane(bank.allocate(numSmoothed)), numLanes(numSmoothed),
+    leader(nullptr), linkParameter(nullptr),
+    numParameters(0), forcedParameters(0), smoothChanges(false),
+    applyingChanges(false), coefficientsStale(false), stageChanged(true)
 {
-    std::vector<ParameterBlueprint> parameters;
-    getParameters(parameters);
-    for (ParameterBlueprint param : parameters)
-    {
-        tree->addParameterListener(getIdForParameter(&param), this);
-    }
-    stateTree = tree;
+    jassert(firstLane + numLanes <= SmootherBank::maxValues);
+    sources.fill(nullptr);
+    appliedValues.fill(0);
+    displayValues.fill(0);
 }
 
-void CtmFilter::stopListeningTo(juce::AudioProcessorValueTreeState* tree)
+// === ValueTreeState =========================================================
+void CtmFilter::attachToTree(juce::AudioProcessorValueTreeState* tree)
 {
     std::vector<ParameterBlueprint> parameters;
     getParameters(parameters);
-    for (ParameterBlueprint param : parameters)
-    {
-        tree->removeParameterListener(getIdForParameter(&param), this);
-    }
-    stateTree = nullptr;
-}
-
-void CtmFilter::parameterChanged(const juce::String& s, float value)
-{
-    juce::String param = s.substring((int)name.length() + 1);
-    onChangedParameter(param, value);
-    for (CtmFilter* otherFilter : linked)
+    jassert(parameters.size() <= maxParameters);
+    numParameters = std::min(parameters.size(), maxParameters);
+    for (size_t i = 0;i < numParameters;i++)
     {
-        otherFilter->onChangedParameter(param, value);
-        otherFilter->nofityListeners();
+        std::string id = getIdForParameter(&parameters[i]);
+        sources[i] = tree->getRawParameterValue(id);
     }
-    nofityListeners();
+    // everything is applied on the first block to pick up the restored state
+    applyAllOnNextBlock();
 }
 
 // === For EQ Displays ========================================================
@@ -59,6 +52,23 @@ void CtmFilter::removeStateListener(FilterStateListener* listener)
         listeners.erase(pos);
 }
 
+bool CtmFilter::hasDisplayChanged()
+{
+    const CtmFilter& source = getValueSource();
+    bool changed = false;
+    for (size_t i = 0;i < numParameters;i++)
+    {
+        float value = readParameter(source, i);
+        if (std::bit_cast<uint32_t>(value)
+            != std::bit_cast<uint32_t>(displayValues[i]))
+        {
+            displayValues[i] = value;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
 // === Parameters =============================================================
 void CtmFilter::addParameters(ParameterLayout* parameters)
 {
@@ -76,31 +86,81 @@ void CtmFilter::addParameters(ParameterLayout* parameters)
 }
 
 // === Linking ================================================================
-void CtmFilter::link(CtmFilter* other)
+void CtmFilter::followWhenLinked
+(const CtmFilter* leaderArg, std::atomic<float>* link)
 {
-    linked.push_back(other);
-    other->setParamsOnLink(name);
-    other->nofityListeners();
+    leader = leaderArg;
+    linkParameter = link;
 }
 
-void CtmFilter::unlink(CtmFilter* other)
+// === Process Audio ==========================================================
+void CtmFilter::applyPendingParameters(bool smooth)
 {
-    linked.erase(
-        std::remove(linked.begin(), linked.end(), other), linked.end()
-    );
-    other->setParamsOnLink(other->name);
-    other->nofityListeners();
+    const CtmFilter& source = getValueSource();
+    uint32_t forced = forcedParameters.exchange(0);
+    uint32_t changed = 0;
+    // compared bit for bit, so the same value never counts as a change and
+    // a bounce applies exactly the changes the host made
+    for (size_t i = 0;i < numParameters;i++)
+    {
+        float value = readParameter(source, i);
+        bool isForced = (forced & (1u << i)) != 0;
+        if (isForced || std::bit_cast<uint32_t>(value)
+            != std::bit_cast<uint32_t>(appliedValues[i]))
+        {
+            appliedValues[i] = value;
+            changed |= 1u << i;
+        }
+    }
+    if (changed == 0)
+        return;
+    smoothChanges = smooth;
+    applyingChanges = true;
+    for (size_t i = 0;i < numParameters;i++)
+    {
+        if ((changed & (1u << i)) != 0)
+            onChangedParameter(i, appliedValues[i]);
+    }
+    applyingChanges = false;
+    if (coefficientsStale)
+    {
+        coefficientsStale = false;
+        updateCoefficients();
+    }
 }
 
-// === Process Audio ==========================================================
-float CtmFilter::processSample(float sample)
+void CtmFilter::applyAllOnNextBlock()
+{
+    forcedParameters.store((1u << numParameters) - 1);
+}
+
+void CtmFilter::processBlock(float* data, size_t numSamples)
 {
-    auto sinceEpoch = std::chrono::system_clock::now().time_since_epoch();
-    long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        sinceEpoch
-    ).count();
-    timeAtLastProcess.store(ms);
-    return processSampleProtected(sample);
+    processBlockProtected(data, numSamples);
+}
+
+void CtmFilter::processBlock(double* data, size_t numSamples)
+{
+    processBlockProtected(data, numSamples);
+}
+
+bool CtmFilter::takeStageChange()
+{
+    bool changed = stageChanged;
+    stageChanged = false;
+    return changed;
+}
+
+void CtmFilter::setCoefficientUpdateInterval(int numSamples)
+{
+    coefficientUpdateInterval = numSamples < 1 ? 1 : numSamples;
+}
+
+void CtmFilter::onSmoothersAdvanced(uint64_t moved)
+{
+    auto own = (uint32_t) ((moved >> firstLane) & ((1u << numLanes) - 1));
+    if (own != 0)
+        onSmoothedMoved(own);
 }
 
 // === Protected & Private ====================================================
@@ -114,11 +174,82 @@ void CtmFilter::nofityListeners()
 
 bool CtmFilter::isProcessing()
 {
-    auto sinceEpoch = std::chrono::system_clock::now().time_since_epoch();
-    long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        sinceEpoch
-    ).count();
-    return timeAtLastProcess.load() >= ms - 2;
+    return smoothChanges;
+}
+
+void CtmFilter::requestCoefficientUpdate()
+{
+    if (applyingChanges)
+        coefficientsStale = true;
+    else
+        updateCoefficients();
+}
+
+void CtmFilter::updateCoefficients() { }
+
+void CtmFilter::markStageChanged()
+{
+    stageChanged = true;
+}
+
+float CtmFilter::getParameterValue(size_t index)
+{
+    if (index >= numParameters)
+        return 0;
+    return readParameter(getValueSource(), index);
+}
+
+float CtmFilter::getSmoothed(size_t index, int offset) const
+{
+    return smoothers.getValue(firstLane + index, offset);
+}
+
+void CtmFilter::setSmoothedTarget(size_t index, float value)
+{
+    smoothers.setTarget(firstLane + index, value);
+}
+
+void CtmFilter::setSmoothedValue(size_t index, float value)
+{
+    smoothers.setCurrentAndTarget(firstLane + index, value);
+}
+
+bool CtmFilter::isSmoothing(size_t index, int offset) const
+{
+    return getSmoothingRemaining(index) > offset;
+}
+
+uint32_t CtmFilter::getSmoothing(int offset) const
+{
+    return smoothers.getSmoothing(firstLane, numLanes, offset);
+}
+
+int CtmFilter::getSmoothingRemaining(size_t index) const
+{
+    return smoothers.getRemaining(firstLane + index);
+}
+
+void CtmFilter::resetSmoothed(double sampleRate)
+{
+    smoothers.reset(firstLane, numLanes, sampleRate, smoothingSeconds);
+}
+
+void CtmFilter::onSmoothedMoved(uint32_t moved)
+{
+    juce::ignoreUnused(moved);
+}
+
+const CtmFilter& CtmFilter::getValueSource() const
+{
+    bool linked = linkParameter != nullptr
+        && linkParameter->load(std::memory_order_relaxed) >= 1;
+    return linked ? *leader : *this;
+}
+
+float CtmFilter::readParameter(const CtmFilter& source, size_t index)
+{
+    std::atomic<float>* value = source.sources[index];
+    return value != nullptr ? value->load(std::memory_order_relaxed) : 0;
 }
 
 std::string CtmFilter::getIdForParameter(const ParameterBlueprint* param)
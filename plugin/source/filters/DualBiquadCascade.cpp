@@ -0,0 +1,98 @@
+#include "DualBiquadCascade.h"
+#include <algorithm>
+
+// === Process Audio ==========================================================
+template <typename SampleType>
+void DualBiquadCascade<SampleType>::processBlock
+(BiquadCascade<SampleType>& one, SampleType* dataOne,
+BiquadCascade<SampleType>& two, SampleType* dataTwo, size_t numSamples)
+{
+    size_t count = std::max(one.numSections, two.numSections);
+    if (count == 0)
+    {
+        one.applyInputGain(dataOne, numSamples);
+        two.applyInputGain(dataTwo, numSamples);
+        return;
+    }
+    // gather both channels into the lanes, padding the shorter one
+    const typename Section::Coefficients identity { 1, 0, 0, 0, 0 };
+    for (size_t s = 0;s < count;s++)
+    {
+        const Section* sectionOne = getSection(one, s);
+        const Section* sectionTwo = getSection(two, s);
+        const typename Section::Coefficients& c1 = sectionOne != nullptr
+            ? sectionOne->coefficients : identity;
+        const typename Section::Coefficients& c2 = sectionTwo != nullptr
+            ? sectionTwo->coefficients : identity;
+        // each channel's input gain is folded into its first section, which
+        // may be a pass-through pad
+        SampleType g1 = s == 0 ? one.inputGain : 1;
+        SampleType g2 = s == 0 ? two.inputGain : 1;
+        b0[s] = pack(c1.b0 * g1, c2.b0 * g2);
+        b1[s] = pack(c1.b1 * g1, c2.b1 * g2);
+        b2[s] = pack(c1.b2 * g1, c2.b2 * g2);
+        a1[s] = pack(c1.a1, c2.a1);
+        a2[s] = pack(c1.a2, c2.a2);
+        state1[s] = pack(
+            sectionOne != nullptr ? sectionOne->state1 : 0,
+            sectionTwo != nullptr ? sectionTwo->state1 : 0
+        );
+        state2[s] = pack(
+            sectionOne != nullptr ? sectionOne->state2 : 0,
+            sectionTwo != nullptr ? sectionTwo->state2 : 0
+        );
+    }
+    // run both chains one sample at a time
+    alignas(Register::SIMDRegisterSize)
+        SampleType lanes[Register::SIMDNumElements] { };
+    for (size_t i = 0;i < numSamples;i++)
+    {
+        lanes[0] = dataOne[i];
+        lanes[1] = dataTwo[i];
+        Register sample = Register::fromRawArray(lanes);
+        for (size_t s = 0;s < count;s++)
+        {
+            Register output = (sample * b0[s]) + state1[s];
+            state1[s] = (sample * b1[s]) - (output * a1[s]) + state2[s];
+            state2[s] = (sample * b2[s]) - (output * a2[s]);
+            sample = output;
+        }
+        sample.copyToRawArray(lanes);
+        dataOne[i] = lanes[0];
+        dataTwo[i] = lanes[1];
+    }
+    // hand the state back to the real sections
+    for (size_t s = 0;s < one.numSections;s++)
+    {
+        one.sections[s]->state1 = Section::snapToZero(state1[s].get(0));
+        one.sections[s]->state2 = Section::snapToZero(state2[s].get(0));
+    }
+    for (size_t s = 0;s < two.numSections;s++)
+    {
+        two.sections[s]->state1 = Section::snapToZero(state1[s].get(1));
+        two.sections[s]->state2 = Section::snapToZero(state2[s].get(1));
+    }
+}
+
+// === Private Helper =========================================================
+template <typename SampleType>
+typename DualBiquadCascade<SampleType>::Register
+DualBiquadCascade<SampleType>::pack(SampleType laneOne, SampleType laneTwo)
+{
+    alignas(Register::SIMDRegisterSize)
+        SampleType lanes[Register::SIMDNumElements] { };
+    lanes[0] = laneOne;
+    lanes[1] = laneTwo;
+    return Register::fromRawArray(lanes);
+}
+
+template <typename SampleType>
+const Biquad<SampleType>* DualBiquadCascade<SampleType>::getSection
+(const Cascade& cascade, size_t index)
+{
+    return index < cascade.numSections ? cascade.sections[index] : nullptr;
+}
+
+// === Instantiations =========================================================
+template class DualBiquadCascade<float>;
+template class DualBiquadCascade<double>;
\ No newline at end of file
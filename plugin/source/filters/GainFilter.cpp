@@ -1,26 +1,31 @@
 #include "GainFilter.h"
+#include <algorithm>
+#include <bit>
 
 // === Lifecycle ==============================================================
-GainFilter::GainFilter(std::string nameArg, std::string parameterText)
-    : CtmFilter(nameArg, parameterText)
+GainFilter::GainFilter
+(SmootherBank& bank, std::string nameArg, std::string parameterText)
+    : CtmFilter(bank, numSmoothed, nameArg, parameterText), linearGain(1)
 {
-    smoothGain.setCurrentAndTargetValue(0);
-    smoothBypass.setCurrentAndTargetValue(1);
+    setSmoothedValue(smoothGain, 0);
+    setSmoothedValue(smoothBypass, 1);
 }
 
 // === Parameters =============================================================
-void GainFilter::onChangedParameter(const juce::String& parameter, float value)
+void GainFilter::onChangedParameter(size_t index, float value)
 {
-    if (parameter.compare(gainParam.idPostfix) == 0)
-        setGain(value);
-    else if (parameter.compare(onOffParam.idPostfix) == 0)
-        setBypass(value <= 0);
+    switch (index)
+    {
+        case onOffIndex: setBypass(value <= 0); break;
+        case gainIndex: setGain(value); break;
+        default: break;
+    }
 }
 
-void GainFilter::getParameters(std::vector<ParameterBlueprint>& params)
+void GainFilter::getParameters(std::vector<ParameterBlueprint>& parameters)
 {
-    params.push_back(onOffParam);
-    params.push_back(gainParam);
+    for (const ParameterBlueprint* param : parameterTable)
+        parameters.push_back(*param);
 }
 
 void GainFilter::getMagnitudes
@@ -28,10 +33,10 @@ void GainFilter::getMagnitudes
 {
     juce::ignoreUnused(frequencies);
     double a;
-    if (smoothBypass.getTargetValue() <= 0)
+    if (getParameterValue(onOffIndex) <= 0)
         a = 1;
     else
-        a = pow(10, smoothGain.getTargetValue() / 20);
+        a = pow(10, getParameterValue(gainIndex) / 20);
     for (size_t i = 0;i < len;i++)
     {
         magnitudes[i] = a;
@@ -41,52 +46,171 @@ void GainFilter::getMagnitudes
 void GainFilter::setGain(float value)
 {
     if (isProcessing())
-        smoothGain.setTargetValue(value);
+        setSmoothedTarget(smoothGain, value);
     else
-        smoothGain.setCurrentAndTargetValue(value);    
+    {
+        setSmoothedValue(smoothGain, value);
+        updateLinearGain();
+    }
 }
 
 void GainFilter::setBypass(bool b)
 {
+    markStageChanged();
     if (isProcessing())
-        smoothBypass.setTargetValue(b ? 0 : 1);
+        setSmoothedTarget(smoothBypass, b ? 0 : 1);
     else
-        smoothBypass.setCurrentAndTargetValue(b ? 0 : 1);
+        setSmoothedValue(smoothBypass, b ? 0 : 1);
 }
 
-// === Linking ================================================================
-void GainFilter::setParamsOnLink(std::string paramName)
+// === Process Audio ==========================================================
+void GainFilter::reset(double sampleRate)
 {
-    std::atomic<float>* param;
-    std::string paramId;
-    paramId = paramName + "-" + onOffParam.idPostfix;
-    if ((param = stateTree->getRawParameterValue(paramId)) != nullptr)
-        setBypass(*param <= 0);
-    paramId = paramName + "-" + gainParam.idPostfix;
-    if ((param = stateTree->getRawParameterValue(paramId)) != nullptr)
-        setGain(*param);
+    resetSmoothed(sampleRate);
+    updateLinearGain();
 }
 
-// === Process Audio ==========================================================
-void GainFilter::reset(int blockSize)
+void GainFilter::processBlockProtected(float* data, size_t numSamples)
 {
-    smoothGain.reset(blockSize);
-    smoothBypass.reset(blockSize);
+    processBlockInternal(data, numSamples);
 }
 
-float GainFilter::processSampleProtected(float sample)
+void GainFilter::processBlockProtected(double* data, size_t numSamples)
 {
-    if (!smoothBypass.isSmoothing() && smoothBypass.getCurrentValue() <= 0)
-        return sample;
-    float result;
-    if (smoothGain.isSmoothing())
-        result = sample * pow(10.0f, smoothGain.getNextValue() / 20.0f);
-    else
-        result = sample * pow(10.0f, smoothGain.getCurrentValue() / 20.0f);
-    if (smoothBypass.isSmoothing())
+    processBlockInternal(data, numSamples);
+}
+
+bool GainFilter::isSteady()
+{
+    return getSmoothing() == 0;
+}
+
+void GainFilter::addSections(BiquadCascade<float>& cascade)
+{
+    // a plain gain has no biquad sections, it is applied before the cascade
+    juce::ignoreUnused(cascade);
+}
+
+void GainFilter::addSections(BiquadCascade<double>& cascade)
+{
+    juce::ignoreUnused(cascade);
+}
+
+bool GainFilter::isActive()
+{
+    return getSmoothed(smoothBypass) > 0 || isSmoothing(smoothBypass);
+}
+
+bool GainFilter::isBypassFading()
+{
+    return isSmoothing(smoothBypass);
+}
+
+double GainFilter::getPoleRadius()
+{
+    // a gain has no poles, so nothing rings
+    return 0;
+}
+
+bool GainFilter::foldInto(BiquadCascade<float>& cascade)
+{
+    return foldIntoInternal(cascade);
+}
+
+bool GainFilter::foldInto(BiquadCascade<double>& cascade)
+{
+    return foldIntoInternal(cascade);
+}
+
+// === Private Helper =========================================================
+void GainFilter::onSmoothedMoved(uint32_t moved)
+{
+    if ((moved & (1u << smoothGain)) != 0)
+        updateLinearGain();
+}
+
+bool GainFilter::isUnity()
+{
+    uint32_t zero = std::bit_cast<uint32_t>(0.0f);
+    return std::bit_cast<uint32_t>(getSmoothed(smoothGain)) == zero;
+}
+
+void GainFilter::updateLinearGain()
+{
+    linearGain = pow(10.0f, getSmoothed(smoothGain) / 20.0f);
+}
+
+template <typename SampleType>
+void GainFilter::processBlockInternal(SampleType* data, size_t numSamples)
+{
+    if (!isSmoothing(smoothBypass) && getSmoothed(smoothBypass) <= 0)
+        return;
+    if (getSmoothing() == 0)
+    {
+        if (!isUnity())
+        {
+            juce::FloatVectorOperations::multiply(
+                data, (SampleType) linearGain, (int) numSamples
+            );
+        }
+        return;
+    }
+    std::array<SampleType, curveLength> curve;
+    size_t start = 0;
+    while (start < numSamples)
     {
-        float p = smoothBypass.getNextValue();
-        result = (result * p) + (sample * (1 - p));
+        size_t length = std::min(numSamples - start, curveLength);
+        fillGainCurve(curve.data(), start, length);
+        juce::FloatVectorOperations::multiply(
+            data + start, curve.data(), (int) length
+        );
+        start += length;
     }
-    return result;
+}
+
+template <typename SampleType>
+void GainFilter::fillGainCurve
+(SampleType* curve, size_t offset, size_t length)
+{
+    // the gain ramps linearly in decibels, so as a multiplier each sample is
+    // the last one times a constant ratio. the curve starts again from the
+    // exact gain every chunk, so rounding never builds up. a ramp that lands
+    // partway through the chunk holds its target for the rest of it
+    int at = (int) offset;
+    int left = std::max(getSmoothingRemaining(smoothGain) - at, 0);
+    size_t steps = std::min(length, (size_t) left);
+    float from = getSmoothed(smoothGain, at);
+    float to = getSmoothed(smoothGain, at + (int) steps);
+    float gain = pow(10.0f, from / 20.0f);
+    if (steps > 0)
+    {
+        float ratio = pow(10.0f, (to - from) / (20.0f * (float) steps));
+        for (size_t i = 0;i < steps;i++)
+        {
+            gain *= ratio;
+            curve[i] = (SampleType) gain;
+        }
+    }
+    float target = pow(10.0f, to / 20.0f);
+    for (size_t i = steps;i < length;i++)
+        curve[i] = (SampleType) target;
+    // the bypass blends between the gain and unity
+    if (isSmoothing(smoothBypass, at))
+    {
+        for (size_t i = 0;i < length;i++)
+        {
+            float p = getSmoothed(smoothBypass, at + (int) i + 1);
+            curve[i] = 1 + ((curve[i] - 1) * (SampleType) p);
+        }
+    }
+}
+
+template <typename SampleType>
+bool GainFilter::foldIntoInternal(BiquadCascade<SampleType>& cascade)
+{
+    if (!isSteady())
+        return false;
+    if (getSmoothed(smoothBypass) > 0 && !isUnity())
+        cascade.setInputGain((SampleType) linearGain);
+    return true;
 }
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "GestureCounter.h"
+
+// === Lifecycle ==============================================================
+GestureCounter::GestureCounter()
+    : openGestures(0), count(0), lastCount(0), mostCount(0),
+    mostRepeated(0) { }
+
+void GestureCounter::attachTo(juce::AudioProcessor& processor)
+{
+    jassert((size_t) processor.getParameters().size() <= maxParameters);
+    for (juce::AudioProcessorParameter* param : processor.getParameters())
+        param->addListener(this);
+}
+
+void GestureCounter::detachFrom(juce::AudioProcessor& processor)
+{
+    for (juce::AudioProcessorParameter* param : processor.getParameters())
+        param->removeListener(this);
+}
+
+// === Any Thread =============================================================
+int GestureCounter::getLastGestureCount() const
+{
+    return lastCount.load();
+}
+
+int GestureCounter::getMostInAGesture() const
+{
+    return mostCount.load();
+}
+
+int GestureCounter::getMostRepeatedInAGesture() const
+{
+    return mostRepeated.load();
+}
+
+// === Parameter Listener =====================================================
+void GestureCounter::parameterValueChanged(int index, float value)
+{
+    juce::ignoreUnused(value);
+    if (openGestures.load() <= 0)
+        return;
+    count++;
+    if (index >= 0 && (size_t) index < maxParameters)
+        changed.set((size_t) index);
+}
+
+void GestureCounter::parameterGestureChanged(int index, bool isStarting)
+{
+    juce::ignoreUnused(index);
+    if (isStarting)
+    {
+        if (openGestures++ == 0)
+        {
+            count.store(0);
+            changed.reset();
+        }
+        return;
+    }
+    if (openGestures.load() <= 0 || --openGestures > 0)
+        return;
+    int finished = count.load();
+    lastCount.store(finished);
+    if (finished > mostCount.load())
+        mostCount.store(finished);
+    int repeated = finished - (int) changed.count();
+    if (repeated > mostRepeated.load())
+        mostRepeated.store(repeated);
+}
\ No newline at end of file
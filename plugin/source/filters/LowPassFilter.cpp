@@ -1,53 +1,45 @@
 #include "LowPassFilter.h"
+#include <algorithm>
 
-using Coefficients = juce::dsp::IIR::Coefficients<float>;
 
 // === Lifecycle ==============================================================
 LowPassFilter::LowPassFilter
-(std::string nameArg, std::string parameterText, std::string secondParamText)
-    : CtmFilter(nameArg, parameterText, secondParamText), order(1),
+(SmootherBank& bank, std::string nameArg, std::string parameterText,
+std::string secondParamText)
+    : CtmFilter(bank, numSmoothed, nameArg, parameterText, secondParamText),
+    order(1),
     pendingOrder(-1), fadeSamples(-1), isShelf(false), sampleRate(48000)
 {
-    smoothCutFreq.setCurrentAndTargetValue(20000);
-    smoothShelfFreq.setCurrentAndTargetValue(20000);
-    smoothBypass.setCurrentAndTargetValue(0);
-    smoothGain.setCurrentAndTargetValue(0);
-    smoothCutRes.setCurrentAndTargetValue(0.71f);
-    smoothShelfRes.setCurrentAndTargetValue(0.71f);
+    setSmoothedValue(smoothCutFreq, 20000);
+    setSmoothedValue(smoothShelfFreq, 20000);
+    setSmoothedValue(smoothBypass, 0);
+    setSmoothedValue(smoothGain, 0);
+    setSmoothedValue(smoothCutRes, 0.71f);
+    setSmoothedValue(smoothShelfRes, 0.71f);
     updateFilters();
 }
 
 // === Parameter Information ==================================================
-void LowPassFilter::onChangedParameter(const juce::String& param, float value)
-{
-    if (param.compare(onOffParam.idPostfix) == 0)
-        setBypass(value <= 0);
-    else if (param.compare(shelfModeParam.idPostfix) == 0)
-        setIsShelf(value >= 1);
-    else if (param.compare(cutFreqParam.idPostfix) == 0)
-        setCutFrequency(value);
-    else if (param.compare(shelfFreqParam.idPostfix) == 0)
-        setShelfFrequency(value);
-    else if (param.compare(falloffParam.idPostfix) == 0)
-        setOrder((int) value / 6);
-    else if (param.compare(shelfGainParam.idPostfix) == 0)
-        setShelfGain(value);
-    else if (param.compare(cutResParam.idPostfix) == 0)
-        setCutResonance(value);
-    else if (param.compare(shelfResParam.idPostfix) == 0)
-        setShelfResonance(value);
+void LowPassFilter::onChangedParameter(size_t index, float value)
+{
+    switch (index)
+    {
+        case onOffIndex: setBypass(value <= 0); break;
+        case cutFreqIndex: setCutFrequency(value); break;
+        case shelfFreqIndex: setShelfFrequency(value); break;
+        case falloffIndex: setOrder((int) value / 6); break;
+        case cutResIndex: setCutResonance(value); break;
+        case shelfResIndex: setShelfResonance(value); break;
+        case shelfModeIndex: setIsShelf(value >= 1); break;
+        case shelfGainIndex: setShelfGain(value); break;
+        default: break;
+    }
 }
 
 void LowPassFilter::getParameters(std::vector<ParameterBlueprint>& parameters)
 {
-    parameters.push_back(onOffParam);
-    parameters.push_back(cutFreqParam);
-    parameters.push_back(shelfFreqParam);
-    parameters.push_back(falloffParam);
-    parameters.push_back(cutResParam);
-    parameters.push_back(shelfResParam);
-    parameters.push_back(shelfModeParam);
-    parameters.push_back(shelfGainParam);
+    for (const ParameterBlueprint* param : parameterTable)
+        parameters.push_back(*param);
 }
 
 void LowPassFilter::getMagnitudes
@@ -55,133 +47,133 @@ void LowPassFilter::getMagnitudes
 {
     for (size_t i = 0;i < len;i++)
         magnitudes[i] = 1;
-    if (smoothBypass.getTargetValue() <= 0)
+    if (getParameterValue(onOffIndex) <= 0)
     {
         return;
     }
-    double* perFilter = new double[len];
+    std::vector<double> perFilter(len);
+    bool shelf = getParameterValue(shelfModeIndex) >= 1;
     float freq;
     float res;
-    if (isShelf)
+    if (shelf)
     {
-        freq = smoothShelfFreq.getTargetValue();
-        res = smoothShelfRes.getTargetValue();
+        freq = getParameterValue(shelfFreqIndex);
+        res = getParameterValue(shelfResIndex);
     }
     else
     {
-        freq = smoothCutFreq.getTargetValue();
-        res = smoothCutRes.getTargetValue();
+        freq = getParameterValue(cutFreqIndex);
+        res = getParameterValue(cutResIndex);
     }
-    int curOrder = pendingOrder == -1 ? order : pendingOrder;
-    if (filterOneEnabled())
+    int curOrder = (int) getParameterValue(falloffIndex) / 6;
+    if (filterOneEnabled(curOrder, shelf))
     {
-        auto coefficients = Coefficients::makeLowPass(
+        auto coefficients = BiquadCoefficients::makeLowPass(
             sampleRate * 2, freq, getQForFilter(1, curOrder, res)
         );
-        coefficients->getMagnitudeForFrequencyArray(
-            frequencies, perFilter, len, sampleRate * 2
+        coefficients.getMagnitudeForFrequencyArray(
+            frequencies, perFilter.data(), len, sampleRate * 2
         );
-        combineMagnitudes(magnitudes, perFilter, len);
+        combineMagnitudes(magnitudes, perFilter.data(), len);
     }
-    if (filterTwoEnabled())
+    if (filterTwoEnabled(curOrder, shelf))
     {
-        auto coefficients = Coefficients::makeLowPass(
+        auto coefficients = BiquadCoefficients::makeLowPass(
             sampleRate * 2, freq, getQForFilter(2, curOrder, res)
         );
-        coefficients->getMagnitudeForFrequencyArray(
-            frequencies, perFilter, len, sampleRate * 2
+        coefficients.getMagnitudeForFrequencyArray(
+            frequencies, perFilter.data(), len, sampleRate * 2
         );
-        combineMagnitudes(magnitudes, perFilter, len);
+        combineMagnitudes(magnitudes, perFilter.data(), len);
     }
-    if (filterThreeEnabled())
+    if (filterThreeEnabled(curOrder, shelf))
     {
-        auto coefficients = Coefficients::makeLowPass(
+        auto coefficients = BiquadCoefficients::makeLowPass(
             sampleRate * 2, freq, getQForFilter(3, curOrder, res)
         );
-        coefficients->getMagnitudeForFrequencyArray(
-            frequencies, perFilter, len, sampleRate * 2
+        coefficients.getMagnitudeForFrequencyArray(
+            frequencies, perFilter.data(), len, sampleRate * 2
         );
-        combineMagnitudes(magnitudes, perFilter, len);
+        combineMagnitudes(magnitudes, perFilter.data(), len);
     }
-    if (filterFourEnabled())
+    if (filterFourEnabled(curOrder, shelf))
     {
-        juce::ReferenceCountedObjectPtr<Coefficients> coefficients;
-        if (isShelf)
+        BiquadCoefficients coefficients;
+        if (shelf)
         {
-            float gain = smoothGain.getTargetValue();
-            coefficients = Coefficients::makeHighShelf(
+            float gain = getParameterValue(shelfGainIndex);
+            coefficients = BiquadCoefficients::makeHighShelf(
                 sampleRate * 2, freq, res, pow(10.0f, gain / 20.f)
             );
         }
         else
         {
-            coefficients = Coefficients::makeFirstOrderLowPass(
+            coefficients = BiquadCoefficients::makeFirstOrderLowPass(
                 sampleRate * 2, freq
             );
         }
-        coefficients->getMagnitudeForFrequencyArray(
-            frequencies, perFilter, len, sampleRate * 2
+        coefficients.getMagnitudeForFrequencyArray(
+            frequencies, perFilter.data(), len, sampleRate * 2
         );
-        combineMagnitudes(magnitudes, perFilter, len);
+        combineMagnitudes(magnitudes, perFilter.data(), len);
     }
 }
 
 // === Set Parameters =========================================================
-void LowPassFilter::reset(double newSampleRate, int samplesPerBlock)
-{
-    filterOne.reset();
-    filterTwo.reset();
-    filterThree.reset();
-    filterFour.reset();
-    smoothCutFreq.reset(samplesPerBlock);
-    smoothShelfFreq.reset(samplesPerBlock);
-    smoothBypass.reset(samplesPerBlock);
-    smoothGain.reset(samplesPerBlock);
-    smoothCutRes.reset(samplesPerBlock);
-    smoothShelfRes.reset(samplesPerBlock);
+void LowPassFilter::reset(double newSampleRate)
+{
+    floatSections.one.reset();
+    floatSections.two.reset();
+    floatSections.three.reset();
+    floatSections.four.reset();
+    doubleSections.one.reset();
+    doubleSections.two.reset();
+    doubleSections.three.reset();
+    doubleSections.four.reset();
+    resetSmoothed(newSampleRate);
     sampleRate = newSampleRate;
+    samplesUntilUpdate = 0;
+    updateFilters();
 }
 
 void LowPassFilter::setBypass(bool isBypassed)
 {
+    markStageChanged();
     if (isProcessing())
-        smoothBypass.setTargetValue(isBypassed ? 0 : 1);
+        setSmoothedTarget(smoothBypass, isBypassed ? 0 : 1);
     else
-        smoothBypass.setCurrentAndTargetValue(isBypassed ? 0 : 1);
+        setSmoothedValue(smoothBypass, isBypassed ? 0 : 1);
 }
 
 void LowPassFilter::setCutFrequency(float newFrequency)
 {
     if (!isShelf && isProcessing())
-        smoothCutFreq.setTargetValue(newFrequency);
+        setSmoothedTarget(smoothCutFreq, newFrequency);
     else
     {
-        smoothCutFreq.setCurrentAndTargetValue(newFrequency);
-        updateFilters();
+        setSmoothedValue(smoothCutFreq, newFrequency);
+        requestCoefficientUpdate();
     }
 }
 
 void LowPassFilter::setShelfFrequency(float newFrequency)
 {
     if (isShelf && isProcessing())
-        smoothShelfFreq.setTargetValue(newFrequency);
+        setSmoothedTarget(smoothShelfFreq, newFrequency);
     else
     {
-        smoothShelfFreq.setCurrentAndTargetValue(newFrequency);
-        updateFilters();
+        setSmoothedValue(smoothShelfFreq, newFrequency);
+        requestCoefficientUpdate();
     }
 }
 
 void LowPassFilter::setOrder(int newOrder)
 {
+    markStageChanged();
+    newOrder = std::clamp(newOrder, 1, 7);
     if (isProcessing())
     {
-        if (newOrder <= 1)
-            pendingOrder = 1;
-        else if (newOrder >= 7)
-            pendingOrder = 7;
-        else
-            pendingOrder = newOrder;
+        pendingOrder = newOrder;
         if (fadeSamples < 0)
         {
             fadeSamples = 0;
@@ -195,111 +187,110 @@ void LowPassFilter::setOrder(int newOrder)
     else
     {
         order = newOrder;
-        updateFilters();
+        requestCoefficientUpdate();
     }
 }
 
 void LowPassFilter::setIsShelf(bool shelf)
 {
+    markStageChanged();
     isShelf = shelf;
-    updateFilters();
+    requestCoefficientUpdate();
 }
 
 void LowPassFilter::setShelfGain(float gain)
 {
     if (isProcessing())
-        smoothGain.setTargetValue(gain);
+        setSmoothedTarget(smoothGain, gain);
     else
     {
-        smoothGain.setCurrentAndTargetValue(gain);
-        updateFilters();
+        setSmoothedValue(smoothGain, gain);
+        requestCoefficientUpdate();
     }
 }
 
 void LowPassFilter::setCutResonance(float res)
 {
     if (!isShelf && isProcessing())
-        smoothCutRes.setTargetValue(res);
+        setSmoothedTarget(smoothCutRes, res);
     else
     {
-        smoothCutRes.setCurrentAndTargetValue(res);
-        updateFilters();
+        setSmoothedValue(smoothCutRes, res);
+        requestCoefficientUpdate();
     }
 }
 
 void LowPassFilter::setShelfResonance(float res)
 {
     if (isShelf && isProcessing())
-        smoothShelfRes.setTargetValue(res);
+        setSmoothedTarget(smoothShelfRes, res);
     else
     {
-        smoothShelfRes.setCurrentAndTargetValue(res);
-        updateFilters();
+        setSmoothedValue(smoothShelfRes, res);
+        requestCoefficientUpdate();
     }
 }
 
-// === Linking ================================================================
-void LowPassFilter::setParamsOnLink(std::string paramName)
-{
-    std::atomic<float>* param;
-    std::string paramId;
-    paramId = onOffParam.getIdWithFilterName(paramName);
-    if ((param = stateTree->getRawParameterValue(paramId)) != nullptr)
-        setBypass(*param <= 0);
-    paramId = cutFreqParam.getIdWithFilterName(paramName);
-    if ((param = stateTree->getRawParameterValue(paramId)) != nullptr)
-        setCutFrequency(*param);
-    paramId = shelfFreqParam.getIdWithFilterName(paramName);
-    if ((param = stateTree->getRawParameterValue(paramId)) != nullptr)
-        setShelfFrequency(*param);
-    paramId = falloffParam.getIdWithFilterName(paramName);
-    if ((param = stateTree->getRawParameterValue(paramId)) != nullptr)
-        setOrder((int)(*param) / 6);
-    paramId = cutResParam.getIdWithFilterName(paramName);
-    if ((param = stateTree->getRawParameterValue(paramId)) != nullptr)
-        setCutResonance(*param);
-    paramId = shelfResParam.getIdWithFilterName(paramName);
-    if ((param = stateTree->getRawParameterValue(paramId)) != nullptr)
-        setShelfResonance(*param);
-    paramId = shelfModeParam.getIdWithFilterName(paramName);
-    if ((param = stateTree->getRawParameterValue(paramId)) != nullptr)
-        setIsShelf(*param >= 1);
-    paramId = shelfGainParam.getIdWithFilterName(paramName);
-    if ((param = stateTree->getRawParameterValue(paramId)) != nullptr)
-        setShelfGain(*param);
+// === Process Audio ==========================================================
+void LowPassFilter::processBlockProtected(float* data, size_t numSamples)
+{
+    processBlockInternal(data, numSamples);
 }
 
-// === Process Audio ==========================================================
-void LowPassFilter::prepare(const dsp::ProcessSpec& spec)
+void LowPassFilter::processBlockProtected(double* data, size_t numSamples)
+{
+    processBlockInternal(data, numSamples);
+}
+
+bool LowPassFilter::isSteady()
+{
+    // coefficient ramps always end with the current control rate interval
+    return !anythingSmoothing() && !anythingTransitioning()
+        && samplesUntilUpdate <= 0;
+}
+
+void LowPassFilter::addSections(BiquadCascade<float>& cascade)
+{
+    addSectionsInternal(cascade);
+}
+
+void LowPassFilter::addSections(BiquadCascade<double>& cascade)
+{
+    addSectionsInternal(cascade);
+}
+
+bool LowPassFilter::isActive()
 {
-    filterOne.prepare(spec);
-    filterTwo.prepare(spec);
-    filterThree.prepare(spec);
-    filterFour.prepare(spec);
+    return getSmoothed(smoothBypass) > 0 || isSmoothing(smoothBypass);
 }
 
-float LowPassFilter::processSampleProtected(float sample)
+bool LowPassFilter::isBypassFading()
 {
-    if (smoothBypass.getCurrentValue() <= 0 && !smoothBypass.isSmoothing())
+    return isSmoothing(smoothBypass);
+}
+
+double LowPassFilter::getPoleRadius()
+{
+    // only the sections of the precision in use hold any state, but both
+    // share their designs
+    return std::max(
+        getPoleRadiusInternal<float>(), getPoleRadiusInternal<double>()
+    );
+}
+
+// === Private Helper =========================================================
+template <typename SampleType>
+SampleType LowPassFilter::processSampleInternal(SampleType sample, int offset)
+{
+    bool fading = isSmoothing(smoothBypass, offset);
+    if (!fading && getSmoothed(smoothBypass, offset) <= 0)
         return sample;
-    if (anythingSmoothing())
-    {
-        float cutFreq = smoothCutFreq.getNextValue();
-        float shelfFreq = smoothShelfFreq.getNextValue();
-        float gain = smoothGain.getNextValue();
-        float cutRes = smoothCutRes.getNextValue();
-        float shelfRes = smoothShelfRes.getNextValue();
-        updateFilters(cutFreq, shelfFreq, gain, cutRes, shelfRes);
-    }
-    float result = sample;
-    if (filterOneEnabled())
-        result = filterOne.processSample(result);
-    if (filterTwoEnabled())
-        result = filterTwo.processSample(result);
-    if (filterThreeEnabled())
-        result = filterThree.processSample(result);
-    if (filterFourEnabled())
-        result = filterFour.processSample(result);
+    if (samplesUntilUpdate <= 0 && anythingSmoothing(offset))
+        updateFiltersAtControlRate(offset);
+    if (samplesUntilUpdate > 0)
+        samplesUntilUpdate--;
+    Sections<SampleType>& sections = getSections<SampleType>();
+    SampleType result = getSampleKernel<SampleType>()(sections, sample);
     if (pendingOrder != -1 || fadeSamples >= 0)
     {
         float gain = std::abs((float)fadeSamples++ - fadeLength) / fadeLength;
@@ -309,121 +300,241 @@ float LowPassFilter::processSampleProtected(float sample)
         result *= gain;
         if (fadeSamples == fadeLength)
         {
-            delayedUpdateOrder();
+            delayedUpdateOrder(offset);
         }
         if (fadeSamples == fadeLength * 2)
         {
             fadeSamples = -1;
         }
     }
-    if (smoothBypass.isSmoothing())
+    if (fading)
     {
-        float p = smoothBypass.getNextValue();
+        float p = getSmoothed(smoothBypass, offset + 1);
         result = (result * p) + (sample * (1 - p));
     }
     return result;
 }
 
-// === Private Helper =========================================================
-void LowPassFilter::updateFilters()
+template <typename SampleType>
+void LowPassFilter::processBlockInternal(SampleType* data, size_t numSamples)
 {
-    float cutFreq = smoothCutFreq.getCurrentValue();
-    float shelfFreq = smoothShelfFreq.getCurrentValue();
-    float gain = smoothGain.getCurrentValue();
-    float cutRes = smoothCutRes.getCurrentValue();
-    float shelfRes = smoothShelfRes.getCurrentValue();
-    updateFilters(cutFreq, shelfFreq, gain, cutRes, shelfRes);
+    if (getSmoothed(smoothBypass) <= 0 && !isSmoothing(smoothBypass))
+        return;
+    if (anythingTransitioning())
+    {
+        for (size_t i = 0;i < numSamples;i++)
+            data[i] = processSampleInternal(data[i], (int) i);
+        return;
+    }
+    // the order and shelf mode can't change inside this loop, so one kernel
+    // lookup covers the whole block
+    Sections<SampleType>& sections = getSections<SampleType>();
+    BlockKernel<SampleType> kernel = getBlockKernel<SampleType>();
+    size_t start = 0;
+    while (start < numSamples)
+    {
+        int at = (int) start;
+        if (samplesUntilUpdate <= 0 && anythingSmoothing(at))
+            updateFiltersAtControlRate(at);
+        size_t length = numSamples - start;
+        if (samplesUntilUpdate > 0)
+        {
+            length = std::min(length, (size_t) samplesUntilUpdate);
+            samplesUntilUpdate -= (int) length;
+        }
+        kernel(sections, data + start, length);
+        start += length;
+    }
 }
 
-void LowPassFilter::updateFilters
-(float cutFreq, float shelfFreq, float gain, float cutRes, float shelfRes)
+template <typename SampleType>
+void LowPassFilter::addSectionsInternal(BiquadCascade<SampleType>& cascade)
 {
+    if (getSmoothed(smoothBypass) <= 0)
+        return;
+    Sections<SampleType>& sections = getSections<SampleType>();
     if (filterOneEnabled())
+        cascade.addSection(&sections.one);
+    if (filterTwoEnabled())
+        cascade.addSection(&sections.two);
+    if (filterThreeEnabled())
+        cascade.addSection(&sections.three);
+    if (filterFourEnabled())
+        cascade.addSection(&sections.four);
+}
+
+template <typename SampleType>
+double LowPassFilter::getPoleRadiusInternal()
+{
+    Sections<SampleType>& sections = getSections<SampleType>();
+    double radius = 0;
+    if (filterOneEnabled())
+        radius = std::max(radius, sections.one.getPoleRadius());
+    if (filterTwoEnabled())
+        radius = std::max(radius, sections.two.getPoleRadius());
+    if (filterThreeEnabled())
+        radius = std::max(radius, sections.three.getPoleRadius());
+    if (filterFourEnabled())
+        radius = std::max(radius, sections.four.getPoleRadius());
+    return radius;
+}
+
+void LowPassFilter::updateFilters(uint32_t moved, int offset, int rampLength)
+{
+    float cutFreq = getSmoothed(smoothCutFreq, offset);
+    float shelfFreq = getSmoothed(smoothShelfFreq, offset);
+    float gain = getSmoothed(smoothGain, offset);
+    float cutRes = getSmoothed(smoothCutRes, offset);
+    float shelfRes = getSmoothed(smoothShelfRes, offset);
+    bool cutMoved = (moved & cutInputs) != 0;
+    bool fourMoved = (moved & (isShelf ? shelfInputs : firstOrderInputs)) != 0;
+    if (filterOneEnabled() && cutMoved)
     {
         float q = getQForFilter(1, order, cutRes);
-        filterOne.coefficients
-            = Coefficients::makeLowPass(sampleRate, cutFreq, q);
+        auto coefficients = BiquadCoefficients::makeLowPass(
+            sampleRate, cutFreq, q
+        );
+        floatSections.one.setCoefficients(coefficients, rampLength);
+        doubleSections.one.setCoefficients(coefficients, rampLength);
     }
-    if (filterTwoEnabled())
+    if (filterTwoEnabled() && cutMoved)
     {
         float q = getQForFilter(2, order, cutRes);
-        filterTwo.coefficients
-            = Coefficients::makeLowPass(sampleRate, cutFreq, q);
+        auto coefficients = BiquadCoefficients::makeLowPass(
+            sampleRate, cutFreq, q
+        );
+        floatSections.two.setCoefficients(coefficients, rampLength);
+        doubleSections.two.setCoefficients(coefficients, rampLength);
     }
-    if (filterThreeEnabled())
+    if (filterThreeEnabled() && cutMoved)
     {
         float q = getQForFilter(3, order, cutRes);
-        filterThree.coefficients
-            = Coefficients::makeLowPass(sampleRate, cutFreq, q);
+        auto coefficients = BiquadCoefficients::makeLowPass(
+            sampleRate, cutFreq, q
+        );
+        floatSections.three.setCoefficients(coefficients, rampLength);
+        doubleSections.three.setCoefficients(coefficients, rampLength);
     }
-    if (filterFourEnabled())
+    if (filterFourEnabled() && fourMoved)
     {
+        BiquadCoefficients coefficients;
         if (isShelf)
         {
-            filterFour.coefficients = Coefficients::makeHighShelf(
+            coefficients = BiquadCoefficients::makeHighShelf(
                 sampleRate, shelfFreq, shelfRes, pow(10.0f, gain / 20.0f)
             );
         }
         else
         {
-            filterFour.coefficients
-                = Coefficients::makeFirstOrderLowPass(sampleRate, cutFreq);
+            coefficients = BiquadCoefficients::makeFirstOrderLowPass(
+                sampleRate, cutFreq
+            );
         }
+        floatSections.four.setCoefficients(coefficients, rampLength);
+        doubleSections.four.setCoefficients(coefficients, rampLength);
     }
 }
 
-void LowPassFilter::delayedUpdateOrder()
+// the sections whose inputs ramp during the next interval are redesigned
+// for its end, and their coefficients ramp there
+void LowPassFilter::updateFiltersAtControlRate(int offset)
+{
+    int steps = coefficientUpdateInterval;
+    uint32_t moving = getSmoothing(offset) & allInputs;
+    updateFilters(moving, offset + steps, steps);
+    samplesUntilUpdate = steps;
+}
+
+template <typename SampleType, int Order, bool Shelf>
+void LowPassFilter::processFilters
+(Sections<SampleType>& sections, SampleType* data, size_t numSamples)
+{
+    if constexpr (filterOneEnabled(Order, Shelf))
+        sections.one.processBlock(data, numSamples);
+    if constexpr (filterTwoEnabled(Order, Shelf))
+        sections.two.processBlock(data, numSamples);
+    if constexpr (filterThreeEnabled(Order, Shelf))
+        sections.three.processBlock(data, numSamples);
+    if constexpr (filterFourEnabled(Order, Shelf))
+        sections.four.processBlock(data, numSamples);
+}
+
+template <typename SampleType, int Order, bool Shelf>
+SampleType LowPassFilter::processFilters
+(Sections<SampleType>& sections, SampleType sample)
+{
+    if constexpr (filterOneEnabled(Order, Shelf))
+        sample = sections.one.processSample(sample);
+    if constexpr (filterTwoEnabled(Order, Shelf))
+        sample = sections.two.processSample(sample);
+    if constexpr (filterThreeEnabled(Order, Shelf))
+        sample = sections.three.processSample(sample);
+    if constexpr (filterFourEnabled(Order, Shelf))
+        sample = sections.four.processSample(sample);
+    return sample;
+}
+
+template <typename SampleType>
+LowPassFilter::BlockKernel<SampleType> LowPassFilter::getBlockKernel()
+{
+    static constexpr std::array<BlockKernel<SampleType>, 8> kernels {
+        &processFilters<SampleType, 0, true>,
+        &processFilters<SampleType, 1, false>,
+        &processFilters<SampleType, 2, false>,
+        &processFilters<SampleType, 3, false>,
+        &processFilters<SampleType, 4, false>,
+        &processFilters<SampleType, 5, false>,
+        &processFilters<SampleType, 6, false>,
+        &processFilters<SampleType, 7, false>
+    };
+    return kernels[(size_t) getTopology()];
+}
+
+template <typename SampleType>
+LowPassFilter::SampleKernel<SampleType> LowPassFilter::getSampleKernel()
+{
+    static constexpr std::array<SampleKernel<SampleType>, 8> kernels {
+        &processFilters<SampleType, 0, true>,
+        &processFilters<SampleType, 1, false>,
+        &processFilters<SampleType, 2, false>,
+        &processFilters<SampleType, 3, false>,
+        &processFilters<SampleType, 4, false>,
+        &processFilters<SampleType, 5, false>,
+        &processFilters<SampleType, 6, false>,
+        &processFilters<SampleType, 7, false>
+    };
+    return kernels[(size_t) getTopology()];
+}
+
+void LowPassFilter::updateCoefficients()
+{
+    updateFilters();
+}
+
+void LowPassFilter::delayedUpdateOrder(int offset)
 {
     order = pendingOrder;
     pendingOrder = -1;
-    updateFilters();
+    updateFilters(allInputs, offset);
 }
 
-bool LowPassFilter::anythingSmoothing()
+bool LowPassFilter::anythingSmoothing(int offset)
 {
-    return smoothCutFreq.isSmoothing() || smoothShelfFreq.isSmoothing()
-        || smoothGain.isSmoothing() || smoothCutRes.isSmoothing()
-        || smoothShelfRes.isSmoothing();
+    return (getSmoothing(offset) & allInputs) != 0;
 }
 
-float LowPassFilter::getQForFilter(int filter, int ord, float res)
+bool LowPassFilter::anythingTransitioning()
 {
-    // result should be overwriten, but default to a neutral q just in case
-    float result = 0.707f;
-    if (filter == 1)
-    {
-        if (ord == 2)
-            result =  0.707f;
-        else if (ord == 3)
-            result =  1;
-        else if (ord == 4)
-            result =  0.541f;
-        else if (ord == 5)
-            result =  0.618f;
-        else if (ord == 6)
-            result =  0.518f;
-        else if (ord == 7)
-            result =  0.555f;
-    }
-    else if (filter == 2)
-    {
-        if (ord == 4)
-            result =  1.307f;
-        else if (ord == 5)
-            result =  1.618f;
-        else if (ord == 6)
-            result =  0.707f;
-        else if (ord == 7)
-            result =  0.802f;
-    }
-    else if (filter == 3)
-    {
-        if (ord == 6)
-            result =  1.932f;
-        else if (ord == 7)
-            result =  2.247f;
-    }
-    int highestBiquad = ord / 2;
+    return isSmoothing(smoothBypass) || pendingOrder != -1
+        || fadeSamples >= 0;
+}
+
+float LowPassFilter::getQForFilter(int filter, int filterOrder, float res)
+{
+    size_t ord = (size_t) std::clamp(filterOrder, 0, 7);
+    size_t section = (size_t) std::clamp(filter - 1, 0, 2);
+    float result = butterworthQ[ord][section];
+    int highestBiquad = filterOrder / 2;
     if (filter == highestBiquad)
     {
         result *= res / 0.707f;
@@ -1,44 +1,50 @@
 #include "PeakFilter.h"
+#include <algorithm>
 
 using Parameter = juce::AudioProcessorValueTreeState::Parameter;
-using Coefficients = juce::dsp::IIR::Coefficients<float>;
 
 // === Lifecycle ==============================================================
 PeakFilter::PeakFilter
-(std::string nameArg, std::string parameterText, float defaultFrequency)
-    : CtmFilter(nameArg, parameterText), defaultFreq(defaultFrequency),
-    gain(1), q(0.707f), sampleRate(48000)
+(SmootherBank& bank, std::string nameArg, std::string parameterText,
+float defaultFrequency)
+    : CtmFilter(bank, numSmoothed, nameArg, parameterText),
+    defaultFreq(defaultFrequency), sampleRate(48000)
 {
-    setFilterParameters(defaultFrequency, gain, q);
-    smoothFrequency.setCurrentAndTargetValue(defaultFrequency);
-    smoothBypass.setCurrentAndTargetValue(1);
+    setSmoothedValue(smoothFreq, defaultFrequency);
+    setSmoothedValue(smoothGain, 1);
+    setSmoothedValue(smoothQ, 0.707f);
+    setFilterParameters();
+    setSmoothedValue(smoothBypass, 1);
 }
 
 // === Parameter Information ==================================================
-void PeakFilter::onChangedParameter(const juce::String& param, float value)
+void PeakFilter::onChangedParameter(size_t index, float value)
 {
-    if (param.compare(onOffParam.idPostfix) == 0)
-        setBypass(value <= 0);
-    else if (param.compare(freqParamIdPostfix) == 0)
-        setFrequency(value);
-    else if (param.compare(gainParam.idPostfix) == 0)
-        setGain(pow(10.0f, value / 20));
-    else if (param.compare(qParam.idPostfix) == 0)
-        setQFactor(value);
+    switch (index)
+    {
+        case onOffIndex: setBypass(value <= 0); break;
+        case gainIndex: setGain(pow(10.0f, value / 20)); break;
+        case qIndex: setQFactor(value); break;
+        case freqIndex: setFrequency(value); break;
+        default: break;
+    }
 }
 
 void PeakFilter::getParameters(std::vector<ParameterBlueprint>& parameters)
 {
-    parameters.push_back(onOffParam);
-    parameters.push_back(gainParam);
-    parameters.push_back(qParam);
-    parameters.push_back(getFreqParameterFields());
+    for (size_t i = 0;i < numParameters;i++)
+    {
+        if (i == freqIndex)
+            parameters.push_back(getFreqParameterFields());
+        else
+            parameters.push_back(*parameterTable[i]);
+    }
 }
 
 void PeakFilter::getMagnitudes
 (const double* frequencies, double* magnitudes, size_t len)
 {
-    if (smoothBypass.getTargetValue() <= 0)
+    if (getParameterValue(onOffIndex) <= 0)
     {
         for (size_t i = 0;i < len;i++)
         {
@@ -47,98 +53,178 @@ void PeakFilter::getMagnitudes
     }
     else
     {
-        auto coefficients = Coefficients::makePeakFilter(
-            sampleRate * 2, smoothFrequency.getTargetValue(), q, gain
+        float freq = getParameterValue(freqIndex);
+        float dB = getParameterValue(gainIndex);
+        float res = getParameterValue(qIndex);
+        auto coefficients = BiquadCoefficients::makePeakFilter(
+            sampleRate * 2, freq, res, pow(10.0f, dB / 20)
         );
-        coefficients->getMagnitudeForFrequencyArray(
+        coefficients.getMagnitudeForFrequencyArray(
             frequencies, magnitudes, len, sampleRate * 2
         );
     }
 }
 
 // === Set Parameters =========================================================
-void PeakFilter::reset(double newSampleRate, int samplesPerBlock)
+void PeakFilter::reset(double newSampleRate)
 {
-    filter.reset();
-    smoothFrequency.reset(samplesPerBlock);
-    smoothBypass.reset(samplesPerBlock);
+    floatFilter.reset();
+    doubleFilter.reset();
+    resetSmoothed(newSampleRate);
     sampleRate = newSampleRate;
+    samplesUntilUpdate = 0;
+    setFilterParameters();
 }
 
 void PeakFilter::setBypass(bool isBypassed)
 {
+    markStageChanged();
     if (isProcessing())
-        smoothBypass.setTargetValue(isBypassed ? 0 : 1);
+        setSmoothedTarget(smoothBypass, isBypassed ? 0 : 1);
     else
-        smoothBypass.setCurrentAndTargetValue(isBypassed ? 0 : 1);
+        setSmoothedValue(smoothBypass, isBypassed ? 0 : 1);
 }
 
 void PeakFilter::setFrequency(float frequency)
 {
-    if (isProcessing())
-        smoothFrequency.setTargetValue(frequency);
-    else
-    {
-        smoothFrequency.setCurrentAndTargetValue(frequency);
-        setFilterParameters(frequency, gain, q);
-    }
+    setSmoothed(smoothFreq, frequency);
 }
 
 void PeakFilter::setGain(float newGain)
 {
-    gain = newGain;
-    setFilterParameters(smoothFrequency.getCurrentValue(), gain, q);
+    setSmoothed(smoothGain, newGain);
 }
 
 void PeakFilter::setQFactor(float newQ)
 {
-    q = newQ;
-    setFilterParameters(smoothFrequency.getCurrentValue(), gain, q);
+    setSmoothed(smoothQ, newQ);
 }
 
-// === Linking ================================================================
-void PeakFilter::setParamsOnLink(std::string paramName)
+// === Process Audio ==========================================================
+void PeakFilter::processBlockProtected(float* data, size_t numSamples)
 {
-    std::atomic<float>* param;
-    std::string paramId;
-    paramId = paramName + "-" + onOffParam.idPostfix;
-    if ((param = stateTree->getRawParameterValue(paramId)) != nullptr)
-        setBypass(*param <= 0);
-    paramId = paramName + "-" + freqParamIdPostfix;
-    if ((param = stateTree->getRawParameterValue(paramId)) != nullptr)
-        setFrequency(*param);
-    paramId = paramName + "-" + gainParam.idPostfix;
-    if ((param = stateTree->getRawParameterValue(paramId)) != nullptr)
-        setGain(pow(10.0f, *param / 20));
-    paramId = paramName + "-" + qParam.idPostfix;
-    if ((param = stateTree->getRawParameterValue(paramId)) != nullptr)
-        setQFactor(*param);
+    processBlockInternal(data, numSamples);
 }
 
-// === Process Audio ==========================================================
-void PeakFilter::prepare(const dsp::ProcessSpec& spec)
+void PeakFilter::processBlockProtected(double* data, size_t numSamples)
+{
+    processBlockInternal(data, numSamples);
+}
+
+bool PeakFilter::isSteady()
+{
+    // coefficient ramps always end with the current control rate interval
+    return getSmoothing() == 0 && samplesUntilUpdate <= 0;
+}
+
+void PeakFilter::addSections(BiquadCascade<float>& cascade)
+{
+    if (getSmoothed(smoothBypass) > 0)
+        cascade.addSection(&floatFilter);
+}
+
+void PeakFilter::addSections(BiquadCascade<double>& cascade)
+{
+    if (getSmoothed(smoothBypass) > 0)
+        cascade.addSection(&doubleFilter);
+}
+
+bool PeakFilter::isActive()
+{
+    return getSmoothed(smoothBypass) > 0 || isSmoothing(smoothBypass);
+}
+
+bool PeakFilter::isBypassFading()
+{
+    return isSmoothing(smoothBypass);
+}
+
+double PeakFilter::getPoleRadius()
+{
+    return std::max(
+        floatFilter.getPoleRadius(), doubleFilter.getPoleRadius()
+    );
+}
+
+// === Private Helper =========================================================
+void PeakFilter::updateCoefficients()
+{
+    setFilterParameters();
+}
+
+void PeakFilter::setSmoothed(Smoothed index, float value)
+{
+    if (isProcessing())
+        setSmoothedTarget(index, value);
+    else
+    {
+        setSmoothedValue(index, value);
+        requestCoefficientUpdate();
+    }
+}
+
+void PeakFilter::setFilterParameters(int offset, int rampLength)
 {
-    filter.prepare(spec);
+    auto coefficients = BiquadCoefficients::makePeakFilter(
+        sampleRate, getSmoothed(smoothFreq, offset),
+        getSmoothed(smoothQ, offset), getSmoothed(smoothGain, offset)
+    );
+    floatFilter.setCoefficients(coefficients, rampLength);
+    doubleFilter.setCoefficients(coefficients, rampLength);
 }
 
-float PeakFilter::processSampleProtected(float sample)
+// the coefficients ramp towards the design one interval ahead
+void PeakFilter::updateFilterAtControlRate(int offset)
 {
-    if (smoothBypass.getCurrentValue() <= 0 && !smoothBypass.isSmoothing())
+    int steps = coefficientUpdateInterval;
+    setFilterParameters(offset + steps, steps);
+    samplesUntilUpdate = steps;
+}
+
+template <typename SampleType>
+SampleType PeakFilter::processSampleInternal(SampleType sample, int offset)
+{
+    bool fading = isSmoothing(smoothBypass, offset);
+    if (!fading && getSmoothed(smoothBypass, offset) <= 0)
         return sample;
-    if (smoothFrequency.isSmoothing())
-        setFilterParameters(smoothFrequency.getNextValue(), gain, q);
-    float result = filter.processSample(sample);
-    if (smoothBypass.isSmoothing())
+    if (samplesUntilUpdate <= 0 && (getSmoothing(offset) & designInputs) != 0)
+        updateFilterAtControlRate(offset);
+    if (samplesUntilUpdate > 0)
+        samplesUntilUpdate--;
+    SampleType result = getFilter<SampleType>().processSample(sample);
+    if (fading)
     {
-        float p = smoothBypass.getNextValue();
+        float p = getSmoothed(smoothBypass, offset + 1);
         result = (result * p) + (sample * (1 - p));
     }
     return result;
 }
 
-// === Private Helper =========================================================
-void PeakFilter::setFilterParameters(float newFreq, float newGain, float newQ)
+template <typename SampleType>
+void PeakFilter::processBlockInternal(SampleType* data, size_t numSamples)
 {
-    filter.coefficients
-        = Coefficients::makePeakFilter(sampleRate, newFreq, newQ, newGain);
+    if (getSmoothed(smoothBypass) <= 0 && !isSmoothing(smoothBypass))
+        return;
+    if (isSmoothing(smoothBypass))
+    {
+        for (size_t i = 0;i < numSamples;i++)
+            data[i] = processSampleInternal(data[i], (int) i);
+        return;
+    }
+    Biquad<SampleType>& filter = getFilter<SampleType>();
+    size_t start = 0;
+    while (start < numSamples)
+    {
+        int at = (int) start;
+        if (samplesUntilUpdate <= 0 && (getSmoothing(at) & designInputs) != 0)
+            updateFilterAtControlRate(at);
+        size_t length = numSamples - start;
+        if (samplesUntilUpdate > 0)
+        {
+            length = std::min(length, (size_t) samplesUntilUpdate);
+            samplesUntilUpdate -= (int) length;
+        }
+        filter.processBlock(data + start, length);
+        start += length;
+    }
 }
\ No newline at end of file
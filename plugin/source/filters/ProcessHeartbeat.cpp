@@ -0,0 +1,37 @@
+#include "ProcessHeartbeat.h"
+#include <chrono>
+#include <cmath>
+
+// === Lifecycle ==============================================================
+ProcessHeartbeat::ProcessHeartbeat() : timeAtLastBeat(0), tolerance(0) { }
+
+void ProcessHeartbeat::reset()
+{
+    timeAtLastBeat.store(0);
+    tolerance.store(0);
+}
+
+// === Audio Thread ===========================================================
+void ProcessHeartbeat::beat(int numSamples, double sampleRate)
+{
+    // the next beat is due one block from now, so allow up to two blocks
+    // of host jitter before audio is considered stopped
+    double blockLength = std::ceil((numSamples * 1000.0) / sampleRate);
+    tolerance.store((2 * (long long) blockLength) + minTolerance);
+    timeAtLastBeat.store(now());
+}
+
+// === Any Thread =============================================================
+bool ProcessHeartbeat::isAlive() const
+{
+    return timeAtLastBeat.load() >= now() - tolerance.load();
+}
+
+// === Private Helper =========================================================
+long long ProcessHeartbeat::now()
+{
+    auto sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        sinceEpoch
+    ).count();
+}
\ No newline at end of file
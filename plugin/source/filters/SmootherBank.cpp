@@ -0,0 +1,95 @@
+#include "SmootherBank.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+// === Lifecycle ==============================================================
+SmootherBank::SmootherBank() : numAllocated(0), rampLength(0)
+{
+    current.fill(0);
+    target.fill(0);
+    increment.fill(0);
+    remaining.fill(0);
+}
+
+size_t SmootherBank::allocate(size_t count)
+{
+    size_t first = numAllocated;
+    numAllocated += count;
+    return first;
+}
+
+void SmootherBank::reset
+(size_t first, size_t count, double sampleRate, double rampSeconds)
+{
+    // matches juce::SmoothedValue, which the filters used before the bank
+    rampLength = (int) std::floor(rampSeconds * sampleRate);
+    for (size_t i = first;i < first + count;i++)
+        setCurrentAndTarget(i, target[i]);
+}
+
+// === Values =================================================================
+void SmootherBank::setTarget(size_t lane, float value)
+{
+    uint32_t bits = std::bit_cast<uint32_t>(value);
+    if (bits == std::bit_cast<uint32_t>(target[lane]))
+        return;
+    if (rampLength <= 0)
+    {
+        setCurrentAndTarget(lane, value);
+        return;
+    }
+    target[lane] = value;
+    remaining[lane] = (float) rampLength;
+    increment[lane] = (value - current[lane]) / (float) rampLength;
+}
+
+void SmootherBank::setCurrentAndTarget(size_t lane, float value)
+{
+    current[lane] = value;
+    target[lane] = value;
+    increment[lane] = 0;
+    remaining[lane] = 0;
+}
+
+float SmootherBank::getValue(size_t lane, int offset) const
+{
+    // ramps are linear until they land, and hold their target after
+    if ((float) offset >= remaining[lane])
+        return target[lane];
+    return current[lane] + (increment[lane] * (float) offset);
+}
+
+int SmootherBank::getRemaining(size_t lane) const
+{
+    return (int) remaining[lane];
+}
+
+uint32_t SmootherBank::getSmoothing
+(size_t first, size_t count, int offset) const
+{
+    float at = (float) offset;
+    uint32_t smoothing = 0;
+    for (size_t i = 0;i < count;i++)
+        smoothing |= (remaining[first + i] > at ? 1u : 0u) << i;
+    return smoothing;
+}
+
+// === Audio Thread ===========================================================
+uint64_t SmootherBank::advance(int numSamples)
+{
+    std::array<float, maxValues> steps;
+    float n = (float) numSamples;
+    for (size_t i = 0;i < maxValues;i++)
+    {
+        steps[i] = std::min(remaining[i], n);
+        current[i] += increment[i] * steps[i];
+        remaining[i] -= steps[i];
+        // finished ramps land exactly on their target
+        current[i] = remaining[i] > 0 ? current[i] : target[i];
+    }
+    uint64_t moved = 0;
+    for (size_t i = 0;i < maxValues;i++)
+        moved |= (uint64_t) (steps[i] > 0 ? 1u : 0u) << i;
+    return moved;
+}
\ No newline at end of file
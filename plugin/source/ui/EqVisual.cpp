@@ -2,7 +2,10 @@
 #include "CtmLookAndFeel.h"
 
 // === Lifecycle ==============================================================
-EqVisual::EqVisual() : bgImageCached(false) { }
+EqVisual::EqVisual() : bgImageCached(false)
+{
+    startTimerHz(refreshRate);
+}
 
 EqVisual::~EqVisual()
 {
@@ -69,6 +72,17 @@ void EqVisual::notify(CtmFilter* filter)
     repaint();
 }
 
+void EqVisual::timerCallback()
+{
+    bool changed = false;
+    for (CtmFilter* filter : filtersForResponseOne)
+        changed |= filter->hasDisplayChanged();
+    for (CtmFilter* filter : filtersForResponseTwo)
+        changed |= filter->hasDisplayChanged();
+    if (changed)
+        repaint();
+}
+
 // === Parameters =============================================================
 void EqVisual::setFrequencyResponseColors(juce::Colour c1, juce::Colour c2)
 {
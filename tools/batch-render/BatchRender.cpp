@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_events/juce_events.h>
+#include "FileRenderer.h"
+#include "WorkStealingPool.h"
+
+// renders every wav and aiff file in a directory through the plugin, with
+// the state saved by a host or a preset xml. the filters run serially within
+// a file, so files are rendered in parallel instead, with one processor per
+// worker thread. given a single file, it is streamed through one processor
+// instead, which suits recordings too long to hold in memory
+
+using Clock = std::chrono::steady_clock;
+
+// === Settings ===============================================================
+static const juce::String audioFilePattern { "*.wav;*.wave;*.aif;*.aiff" };
+static const int defaultBlockSize { 512 };
+
+// === Arguments ==============================================================
+static void printUsage()
+{
+    std::printf(
+        "usage: Split-EQ-BatchRender <state> <input dir> <output dir>\n"
+        "                            [--threads=n] [--block-size=n]\n"
+        "                            [--double-state] [--automation=file]\n"
+        "       Split-EQ-BatchRender <state> <input file> <output file>\n"
+        "                            [--block-size=n] [--double-state]\n"
+        "                            [--automation=file]\n"
+        "  <state> is a saved plugin state or a preset xml\n"
+        "  --double-state filters in double precision\n"
+        "  --automation is a file of timed changes, one per line, as\n"
+        "    <seconds> <parameter id> <value>\n"
+    );
+}
+
+static int getIntOption
+(const juce::ArgumentList& args, const juce::String& option, int fallback)
+{
+    if (!args.containsOption(option))
+        return fallback;
+    return std::max(1, args.getValueForOption(option).getIntValue());
+}
+
+// accepts both the binary blob from getStateInformation and its xml, which is
+// what presets are saved as
+static bool loadState(const juce::File& file, juce::MemoryBlock& state)
+{
+    if (!file.loadFileAsData(state))
+        return false;
+    if (!file.loadFileAsString().trimStart().startsWith("<"))
+        return true;
+    std::unique_ptr<juce::XmlElement> xml = juce::parseXML(file);
+    if (xml == nullptr)
+        return false;
+    state.reset();
+    juce::AudioProcessor::copyXmlToBinary(*xml, state);
+    return true;
+}
+
+// everything a renderer is set up with before its first file
+struct RenderOptions
+{
+    int blockSize;
+    bool doubleState;
+    juce::File automation;
+};
+
+static std::unique_ptr<FileRenderer> makeRenderer
+(const juce::MemoryBlock& state, const RenderOptions& options)
+{
+    auto renderer = std::make_unique<FileRenderer>(
+        options.blockSize, options.doubleState
+    );
+    if (!renderer->loadState(state))
+    {
+        std::printf("the state is not a Split EQ state\n");
+        return nullptr;
+    }
+    if (options.automation == juce::File())
+        return renderer;
+    juce::Result result = renderer->loadAutomation(options.automation);
+    if (result.failed())
+    {
+        std::printf("%s\n", result.getErrorMessage().toRawUTF8());
+        return nullptr;
+    }
+    return renderer;
+}
+
+// === Render =================================================================
+static double getSpeed(double audioSeconds, Clock::time_point start)
+{
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    return audioSeconds / std::max(elapsed.count(), 1.0e-9);
+}
+
+static int renderFile
+(const juce::MemoryBlock& state, const juce::File& input,
+const juce::File& output, const RenderOptions& options)
+{
+    std::unique_ptr<FileRenderer> renderer = makeRenderer(state, options);
+    if (renderer == nullptr)
+        return 1;
+    double seconds = 0;
+    auto start = Clock::now();
+    juce::Result result = renderer->render(input, output, seconds);
+    if (result.failed())
+    {
+        std::printf("%s\n", result.getErrorMessage().toRawUTF8());
+        return 1;
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    std::printf(
+        "%.1f s of audio in %.1f s (%.1fx real time)\n",
+        seconds, elapsed.count(), getSpeed(seconds, start)
+    );
+    return 0;
+}
+
+static int renderDirectory
+(const juce::MemoryBlock& state, const juce::File& inputDir,
+const juce::File& outputDir, int threads, const RenderOptions& options)
+{
+    if (!outputDir.createDirectory())
+    {
+        std::printf("could not create the output directory\n");
+        return 1;
+    }
+    juce::Array<juce::File> files = inputDir.findChildFiles(
+        juce::File::findFiles, false, audioFilePattern
+    );
+    // longest first, so the last file to finish is a short one
+    std::sort(files.begin(), files.end(),
+        [] (const juce::File& a, const juce::File& b)
+            { return a.getSize() > b.getSize(); });
+    WorkStealingPool pool(
+        (size_t) std::clamp(threads, 1, std::max(1, files.size()))
+    );
+    // processors are made and loaded up front, as the message thread would
+    std::vector<std::unique_ptr<FileRenderer>> renderers;
+    for (size_t i = 0;i < pool.getNumWorkers();i++)
+    {
+        renderers.push_back(makeRenderer(state, options));
+        if (renderers.back() == nullptr)
+            return 1;
+    }
+
+    std::vector<double> seconds((size_t) files.size(), 0);
+    std::atomic<size_t> finished { 0 };
+    std::atomic<size_t> failed { 0 };
+    auto start = Clock::now();
+    pool.run((size_t) files.size(), [&] (size_t worker, size_t job)
+    {
+        const juce::File& input = files.getReference((int) job);
+        juce::File output = outputDir.getChildFile(input.getFileName());
+        auto fileStart = Clock::now();
+        juce::Result result = renderers[worker]->render(
+            input, output, seconds[job]
+        );
+        if (result.failed())
+        {
+            failed++;
+            std::printf(
+                "[%zu/%d] %s %s\n", ++finished, files.size(),
+                input.getFileName().toRawUTF8(),
+                result.getErrorMessage().toRawUTF8()
+            );
+        }
+        else
+        {
+            std::printf(
+                "[%zu/%d] %s ok (%.1fx real time)\n", ++finished,
+                files.size(), input.getFileName().toRawUTF8(),
+                getSpeed(seconds[job], fileStart)
+            );
+        }
+        std::fflush(stdout);
+    });
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    double audio = 0;
+    for (double s : seconds)
+        audio += s;
+    std::printf(
+        "%d files, %zu failed, %.1f s of audio in %.1f s on %zu threads "
+        "(%.1fx real time)\n",
+        files.size(), failed.load(), audio, elapsed.count(),
+        pool.getNumWorkers(), getSpeed(audio, start)
+    );
+    return failed > 0 ? 1 : 0;
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+    juce::StringArray paths;
+    for (const juce::ArgumentList::Argument& arg : args.arguments)
+    {
+        if (!arg.isOption())
+            paths.add(arg.text);
+    }
+    if (paths.size() != 3)
+    {
+        printUsage();
+        return 1;
+    }
+    juce::File workingDir = juce::File::getCurrentWorkingDirectory();
+    juce::File stateFile = workingDir.getChildFile(paths[0]);
+    juce::File input = workingDir.getChildFile(paths[1]);
+    juce::File output = workingDir.getChildFile(paths[2]);
+    if (input == output)
+    {
+        std::printf("the input and output must differ\n");
+        return 1;
+    }
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::MemoryBlock state;
+    if (!loadState(stateFile, state))
+    {
+        std::printf("could not read %s\n", paths[0].toRawUTF8());
+        return 1;
+    }
+    RenderOptions options {
+        getIntOption(args, "--block-size", defaultBlockSize),
+        args.containsOption("--double-state"),
+        juce::File()
+    };
+    if (args.containsOption("--automation"))
+    {
+        options.automation = workingDir.getChildFile(
+            args.getValueForOption("--automation")
+        );
+    }
+    if (input.existsAsFile())
+        return renderFile(state, input, output, options);
+    if (!input.isDirectory())
+    {
+        std::printf("could not find %s\n", paths[1].toRawUTF8());
+        return 1;
+    }
+    int threads = getIntOption(
+        args, "--threads", juce::SystemStats::getNumCpus()
+    );
+    return renderDirectory(state, input, output, threads, options);
+}
\ No newline at end of file
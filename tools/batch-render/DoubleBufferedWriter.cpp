@@ -0,0 +1,97 @@
+#include "DoubleBufferedWriter.h"
+#include <algorithm>
+
+// === Lifecycle ==============================================================
+DoubleBufferedWriter::DoubleBufferedWriter
+(std::unique_ptr<juce::AudioFormatWriter> writerArg, int numChannels,
+int frames)
+    : writer(std::move(writerArg)), filling(0), fillPosition(0), pending(-1),
+    pendingLength(0), stopping(false), failed(false)
+{
+    for (juce::AudioBuffer<float>& buffer : buffers)
+        buffer.setSize(numChannels, frames);
+    thread = std::thread([this] { writeLoop(); });
+}
+
+DoubleBufferedWriter::~DoubleBufferedWriter()
+{
+    finish();
+}
+
+// === Write ==================================================================
+void DoubleBufferedWriter::write
+(const juce::AudioBuffer<float>& source, int numSamples)
+{
+    int frames = buffers[0].getNumSamples();
+    int channels = std::min(
+        source.getNumChannels(), buffers[0].getNumChannels()
+    );
+    int start = 0;
+    while (start < numSamples)
+    {
+        int length = std::min(numSamples - start, frames - fillPosition);
+        for (int c = 0;c < channels;c++)
+        {
+            buffers[(size_t) filling].copyFrom(
+                c, fillPosition, source, c, start, length
+            );
+        }
+        fillPosition += length;
+        start += length;
+        if (fillPosition == frames)
+            submit();
+    }
+}
+
+bool DoubleBufferedWriter::finish()
+{
+    if (!thread.joinable())
+        return !failed;
+    if (fillPosition > 0)
+        submit();
+    {
+        std::scoped_lock scopedLock(lock);
+        stopping = true;
+    }
+    changed.notify_all();
+    thread.join();
+    // closing the writer is what finishes the file's header
+    writer.reset();
+    return !failed;
+}
+
+// === Private Helper =========================================================
+void DoubleBufferedWriter::submit()
+{
+    std::unique_lock uniqueLock(lock);
+    changed.wait(uniqueLock, [this] { return pending < 0; });
+    pending = filling;
+    pendingLength = fillPosition;
+    uniqueLock.unlock();
+    changed.notify_all();
+    filling = 1 - filling;
+    fillPosition = 0;
+}
+
+void DoubleBufferedWriter::writeLoop()
+{
+    while (true)
+    {
+        std::unique_lock uniqueLock(lock);
+        changed.wait(uniqueLock, [this] { return pending >= 0 || stopping; });
+        if (pending < 0)
+            return;
+        int index = pending;
+        int length = pendingLength;
+        uniqueLock.unlock();
+        // the buffer being written is never the one being filled, so the
+        // disk write happens without holding the lock
+        const juce::AudioBuffer<float>& buffer = buffers[(size_t) index];
+        if (!writer->writeFromAudioSampleBuffer(buffer, 0, length))
+            failed = true;
+        uniqueLock.lock();
+        pending = -1;
+        uniqueLock.unlock();
+        changed.notify_all();
+    }
+}
\ No newline at end of file
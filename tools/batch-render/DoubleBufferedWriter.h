@@ -0,0 +1,46 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <juce_audio_formats/juce_audio_formats.h>
+
+// writes audio on a thread of its own, so the renderer never waits on the
+// disk unless the disk falls a whole buffer behind. one buffer is filled
+// while the other is written, and the two swap once the filled one is full.
+// memory use is two buffers no matter how long the file is
+class DoubleBufferedWriter
+{
+public:
+    // === Lifecycle ==========================================================
+    DoubleBufferedWriter
+    (std::unique_ptr<juce::AudioFormatWriter>, int numChannels, int frames);
+    ~DoubleBufferedWriter();
+
+    // === Write ==============================================================
+    // copies the samples, and only blocks while both buffers are full
+    void write(const juce::AudioBuffer<float>&, int numSamples);
+    // writes whatever is left, closes the file and returns false if anything
+    // failed to write
+    bool finish();
+
+private:
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    std::array<juce::AudioBuffer<float>, 2> buffers;
+    int filling;
+    int fillPosition;
+    // the buffer handed to the thread, or -1 while the thread is idle
+    int pending;
+    int pendingLength;
+    bool stopping;
+    std::atomic<bool> failed;
+    std::mutex lock;
+    std::condition_variable changed;
+    std::thread thread;
+
+    // === Private Helper =====================================================
+    void submit();
+    void writeLoop();
+};
\ No newline at end of file
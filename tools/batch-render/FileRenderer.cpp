@@ -0,0 +1,196 @@
+#include "FileRenderer.h"
+#include <algorithm>
+#include <cmath>
+
+// === Lifecycle ==============================================================
+FileRenderer::FileRenderer(int blockSizeArg, bool doubleState)
+    : buffer(2, blockSizeArg), blockSize(blockSizeArg)
+{
+    formats.registerBasicFormats();
+    processor.setDoublePrecisionState(doubleState);
+}
+
+// === State ==================================================================
+bool FileRenderer::loadState(const juce::MemoryBlock& state)
+{
+    return processor.restoreState(state.getData(), (int) state.getSize());
+}
+
+// === Automation =============================================================
+juce::Result FileRenderer::loadAutomation(const juce::File& file)
+{
+    automation.clear();
+    if (!file.existsAsFile())
+        return juce::Result::fail("could not find " + file.getFileName());
+    juce::StringArray lines;
+    lines.addLines(file.loadFileAsString());
+    for (int i = 0;i < lines.size();i++)
+    {
+        juce::String line = lines[i].trim();
+        if (line.isEmpty() || line.startsWith("#"))
+            continue;
+        juce::StringArray tokens;
+        tokens.addTokens(line, " \t", "");
+        tokens.removeEmptyStrings();
+        juce::String where = file.getFileName() + ":" + juce::String(i + 1);
+        if (tokens.size() != 3)
+            return juce::Result::fail(where + " is not <seconds> <id> <value>");
+        juce::RangedAudioParameter* param = findParameter(tokens[1]);
+        if (param == nullptr)
+            return juce::Result::fail(where + " has no parameter " + tokens[1]);
+        float value = param->convertTo0to1(tokens[2].getFloatValue());
+        double seconds = std::max(0.0, tokens[0].getDoubleValue());
+        automation.push_back({ seconds, param, value });
+    }
+    std::stable_sort(automation.begin(), automation.end(),
+        [] (const TimedChange& a, const TimedChange& b)
+            { return a.seconds < b.seconds; });
+    return juce::Result::ok();
+}
+
+// === Render =================================================================
+juce::Result FileRenderer::render
+(const juce::File& input, const juce::File& output, double& seconds)
+{
+    juce::MemoryMappedAudioFormatReader* mapped = nullptr;
+    std::unique_ptr<juce::AudioFormatReader> reader(
+        createReader(input, mapped)
+    );
+    if (reader == nullptr)
+        return juce::Result::fail("not a readable audio file");
+    if (reader->numChannels > 2)
+        return juce::Result::fail("only mono and stereo files are supported");
+    juce::AudioFormat* format =
+        formats.findFormatForFileExtension(output.getFileExtension());
+    if (format == nullptr)
+        return juce::Result::fail("no format for " + output.getFileName());
+    int bits = (int) reader->bitsPerSample;
+    if (!format->getPossibleBitDepths().contains(bits))
+        bits = 24;
+
+    // written next to the output and moved into place once complete, so an
+    // interrupted batch never leaves a partial file behind
+    juce::TemporaryFile temp(output);
+    auto stream = std::make_unique<juce::FileOutputStream>(temp.getFile());
+    if (!stream->openedOk())
+        return juce::Result::fail(stream->getStatus().getErrorMessage());
+    std::unique_ptr<juce::AudioFormatWriter> formatWriter(
+        format->createWriterFor(
+            stream.get(), reader->sampleRate, 2, bits,
+            reader->metadataValues, 0
+        )
+    );
+    if (formatWriter == nullptr)
+        return juce::Result::fail("could not create a writer");
+    stream.release();
+    DoubleBufferedWriter writer(std::move(formatWriter), 2, writeBufferFrames);
+
+    // every file starts from the loaded state, whatever the automation of
+    // the file before left the parameters at
+    std::vector<float> loadedValues;
+    for (const TimedChange& change : automation)
+        loadedValues.push_back(change.parameter->getValue());
+    processor.setPlayConfigDetails(2, 2, reader->sampleRate, blockSize);
+    processor.prepareToPlay(reader->sampleRate, blockSize);
+    juce::int64 length = reader->lengthInSamples;
+    size_t nextChange = 0;
+    juce::Result result = juce::Result::ok();
+    for (juce::int64 position = 0;position < length;position += blockSize)
+    {
+        int size = (int) std::min((juce::int64) blockSize, length - position);
+        if (mapped != nullptr && !mapWindow(*mapped, position, size))
+        {
+            result = juce::Result::fail("could not map the input");
+            break;
+        }
+        juce::int64 end = position + size;
+        if (!scheduleAutomation(end, reader->sampleRate, nextChange))
+        {
+            result = juce::Result::fail("too many changes in one block");
+            break;
+        }
+        buffer.setSize(2, size, false, false, true);
+        reader->read(&buffer, 0, size, position, true, true);
+        if (reader->numChannels == 1)
+            buffer.copyFrom(1, 0, buffer, 0, 0, size);
+        processor.processBlock(buffer, midi);
+        writer.write(buffer, size);
+    }
+    processor.releaseResources();
+    setAutomatedValues(loadedValues);
+    if (result.failed())
+        return result;
+    if (!writer.finish())
+        return juce::Result::fail("could not write the output");
+    if (!temp.overwriteTargetFileWithTemporary())
+        return juce::Result::fail("could not replace the output");
+    seconds = (double) length / reader->sampleRate;
+    return juce::Result::ok();
+}
+
+// === Private Helper =========================================================
+juce::AudioFormatReader* FileRenderer::createReader
+(const juce::File& input, juce::MemoryMappedAudioFormatReader*& mapped)
+{
+    // formats that can be memory mapped are, so that the file is paged in
+    // window by window instead of being copied through a stream
+    juce::AudioFormat* format =
+        formats.findFormatForFileExtension(input.getFileExtension());
+    if (format != nullptr)
+        mapped = format->createMemoryMappedReader(input);
+    if (mapped != nullptr)
+        return mapped;
+    return formats.createReaderFor(input);
+}
+
+juce::RangedAudioParameter* FileRenderer::findParameter
+(const juce::String& id)
+{
+    for (juce::AudioProcessorParameter* param : processor.getParameters())
+    {
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(param);
+        if (ranged != nullptr && ranged->getParameterID() == id)
+            return ranged;
+    }
+    return nullptr;
+}
+
+bool FileRenderer::scheduleAutomation
+(juce::int64 end, double sampleRate, size_t& next)
+{
+    // changes are handed over a block ahead, so the processor's queue only
+    // ever holds one block's worth however long the automation is
+    for (;next < automation.size();next++)
+    {
+        const TimedChange& change = automation[next];
+        auto position = (juce::int64) std::llround(change.seconds * sampleRate);
+        if (position >= end)
+            return true;
+        if (!processor.scheduleParameterChange(
+            change.parameter, change.normalisedValue, position
+        ))
+            return false;
+    }
+    return true;
+}
+
+void FileRenderer::setAutomatedValues(const std::vector<float>& values)
+{
+    // set back in reverse, so a parameter changed more than once ends on
+    // the value it had before its first change
+    for (size_t i = values.size();i > 0;i--)
+        automation[i - 1].parameter->setValue(values[i - 1]);
+}
+
+bool FileRenderer::mapWindow
+(juce::MemoryMappedAudioFormatReader& reader, juce::int64 position, int size)
+{
+    // only one window is ever mapped, which keeps the pages of the input
+    // held in memory the same for any length of file
+    juce::Range<juce::int64> needed(position, position + size);
+    if (reader.getMappedSection().contains(needed))
+        return true;
+    juce::int64 window = std::max(mapWindowFrames, (juce::int64) size);
+    juce::int64 end = std::min(reader.lengthInSamples, position + window);
+    return reader.mapSectionOfFile({ position, end });
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "PluginProcessor.h"
+#include "DoubleBufferedWriter.h"
+
+// renders audio files through a PluginProcessor of its own. a renderer is
+// only ever used by one thread at a time, so a batch runs one renderer per
+// worker and never shares a processor between files being rendered at once
+class FileRenderer
+{
+public:
+    // === Lifecycle ==========================================================
+    // with double state, the float audio read from files is filtered in
+    // double precision
+    FileRenderer(int blockSize, bool doubleState);
+
+    // === State ==============================================================
+    // takes a getStateInformation blob, and fails on anything that is not
+    // a saved Split EQ state
+    bool loadState(const juce::MemoryBlock& state);
+
+    // === Automation =========================================================
+    // parameter changes to make while rendering, each on its exact sample so
+    // the result is the same at any block size. the file has one change per
+    // line, as "<seconds> <parameter id> <value>" with the value in the
+    // parameter's own units. lines starting with # are skipped. fails on
+    // unknown ids and malformed lines
+    juce::Result loadAutomation(const juce::File&);
+
+    // === Render =============================================================
+    // renders input to output in the same format and bit depth, starting
+    // from silent filters. mono files are run as dual mono and written as
+    // stereo, since the two sides of the eq can differ. the input is read
+    // through a sliding memory mapped window where the format allows it and
+    // the output is written in the background, so memory use is the same
+    // for a file of any length
+    juce::Result render
+    (const juce::File& input, const juce::File& output, double& seconds);
+
+private:
+    struct TimedChange
+    {
+        double seconds;
+        juce::RangedAudioParameter* parameter;
+        float normalisedValue;
+    };
+
+    PluginProcessor processor;
+    juce::AudioFormatManager formats;
+    juce::AudioBuffer<float> buffer;
+    juce::MidiBuffer midi;
+    int blockSize;
+    // in time order, as the processor expects them
+    std::vector<TimedChange> automation;
+
+    inline static const juce::int64 mapWindowFrames { 1 << 20 };
+    inline static const int writeBufferFrames { 1 << 16 };
+
+    // === Private Helper =====================================================
+    juce::AudioFormatReader* createReader
+    (const juce::File&, juce::MemoryMappedAudioFormatReader*& mapped);
+    static bool mapWindow
+    (juce::MemoryMappedAudioFormatReader&, juce::int64 position, int size);
+    juce::RangedAudioParameter* findParameter(const juce::String& id);
+    // hands the processor every change due before end. false if its queue
+    // fills up
+    bool scheduleAutomation(juce::int64 end, double sampleRate, size_t& next);
+    void setAutomatedValues(const std::vector<float>&);
+};
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <thread>
+
+// === Lifecycle ==============================================================
+WorkStealingPool::WorkStealingPool(size_t numWorkers)
+{
+    for (size_t i = 0;i < std::max(numWorkers, (size_t) 1);i++)
+        queues.push_back(std::make_unique<Queue>());
+}
+
+// === Run Jobs ===============================================================
+void WorkStealingPool::run(size_t numJobs, const Job& job)
+{
+    for (size_t i = 0;i < numJobs;i++)
+        queues[i % queues.size()]->jobs.push_back(i);
+    std::vector<std::jthread> workers;
+    for (size_t w = 0;w < queues.size();w++)
+    {
+        workers.emplace_back([this, &job, w]
+        {
+            size_t next;
+            while (takeOwnJob(w, next) || stealJob(w, next))
+                job(w, next);
+        });
+    }
+    // jthread joins when the workers go out of scope
+}
+
+// === Private Helper =========================================================
+bool WorkStealingPool::takeOwnJob(size_t worker, size_t& job)
+{
+    Queue& queue = *queues[worker];
+    std::scoped_lock lock(queue.lock);
+    if (queue.jobs.empty())
+        return false;
+    job = queue.jobs.front();
+    queue.jobs.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::stealJob(size_t worker, size_t& job)
+{
+    // start with the next worker along, so thieves spread over the victims
+    for (size_t i = 1;i < queues.size();i++)
+    {
+        Queue& victim = *queues[(worker + i) % queues.size()];
+        std::scoped_lock lock(victim.lock);
+        if (victim.jobs.empty())
+            continue;
+        job = victim.jobs.back();
+        victim.jobs.pop_back();
+        return true;
+    }
+    return false;
+}
\ No newline at end of file
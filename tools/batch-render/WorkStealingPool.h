@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// runs a fixed set of jobs over a fixed set of worker threads. jobs are
+// dealt out to the workers up front, each worker takes its own jobs from the
+// front of its queue, and a worker that runs dry steals from the back of the
+// other queues, so one long job never leaves the other workers idle. jobs
+// are only identified by their index, and every call tells the job which
+// worker it is running on, so state can be kept per worker without locking
+class WorkStealingPool
+{
+public:
+    using Job = std::function<void(size_t worker, size_t job)>;
+
+    // === Lifecycle ==========================================================
+    explicit WorkStealingPool(size_t numWorkers);
+
+    // === Run Jobs ===========================================================
+    // blocks until every job has run. jobs are dealt out in order, so
+    // passing the longest jobs first gives the shortest total time
+    void run(size_t numJobs, const Job& job);
+    inline size_t getNumWorkers() const { return queues.size(); }
+
+private:
+    struct Queue
+    {
+        std::mutex lock;
+        std::deque<size_t> jobs;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+
+    // === Private Helper =====================================================
+    bool takeOwnJob(size_t worker, size_t& job);
+    bool stealJob(size_t worker, size_t& job);
+};
\ No newline at end of file
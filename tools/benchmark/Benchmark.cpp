@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <vector>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_events/juce_events.h>
+#include "PluginProcessor.h"
+
+// headless benchmark for the dsp engine. every combination of sample rate,
+// block size, channel mode, cut filter falloff and band state is timed
+// through PluginProcessor::processBlock. each stage is then timed again on
+// its own through the per-filter path, so a regression can be traced to the
+// filter that caused it. all times are in nanoseconds per stereo frame
+
+using Clock = std::chrono::steady_clock;
+using Stage = std::function<void(PluginProcessor&, float*, float*, size_t)>;
+
+// === Settings ===============================================================
+static const std::vector<double> sampleRates
+    { 44100, 48000, 88200, 96000, 176400, 192000 };
+static const std::vector<int> blockSizes
+    { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+static const std::vector<int> falloffs { 6, 12, 18, 24, 30, 36 };
+// long enough to swamp timer resolution, short enough to sweep everything
+static const double secondsPerMeasurement { 0.5 };
+// covers parameter smoothing and the fades that follow a falloff change
+static const double secondsOfWarmup { 0.1 };
+
+// === Configuration ==========================================================
+static void setParameter
+(PluginProcessor& processor, const juce::String& id, float value)
+{
+    juce::RangedAudioParameter* param = processor.tree.getParameter(id);
+    if (param != nullptr)
+        param->setValueNotifyingHost(param->convertTo0to1(value));
+}
+
+static void configure
+(PluginProcessor& processor, bool midSide, int falloff, bool bandsOn)
+{
+    float on = bandsOn ? 1.0f : 0.0f;
+    // the mode parameter reads 0 as mid-side and 1 as stereo
+    setParameter(processor, "mode", midSide ? 0.0f : 1.0f);
+    for (juce::String channel : { "1", "2" })
+    {
+        setParameter(processor, "gain" + channel + "-on", on);
+        setParameter(processor, "gain" + channel + "-gain", 1.5f);
+        setParameter(processor, "hpf" + channel + "-on", on);
+        setParameter(processor, "hpf" + channel + "-freq", 80);
+        setParameter(processor, "hpf" + channel + "-falloff", (float) falloff);
+        setParameter(processor, "lpf" + channel + "-on", on);
+        setParameter(processor, "lpf" + channel + "-freq", 12000);
+        setParameter(processor, "lpf" + channel + "-falloff", (float) falloff);
+    }
+    for (juce::String peak : { "1", "2", "3", "4", "5", "6" })
+    {
+        setParameter(processor, "peak" + peak + "-on", on);
+        setParameter(processor, "peak" + peak + "-gain", 3);
+        setParameter(processor, "peak" + peak + "-q", 1.2f);
+    }
+}
+
+// === Timing =================================================================
+static void fillWithNoise(juce::AudioBuffer<float>& buffer)
+{
+    juce::Random random(1234);
+    for (int c = 0;c < buffer.getNumChannels();c++)
+    {
+        float* data = buffer.getWritePointer(c);
+        for (int i = 0;i < buffer.getNumSamples();i++)
+            data[i] = (random.nextFloat() - 0.5f) * 0.5f;
+    }
+}
+
+// runs the given work over a fresh copy of the noise for every block and
+// returns the total time taken. the copies are included in the time, and
+// are measured separately so they can be subtracted
+static double timeBlocks
+(const juce::AudioBuffer<float>& noise, juce::AudioBuffer<float>& block,
+size_t numSamples, const std::function<void(juce::AudioBuffer<float>&)>& work)
+{
+    juce::ScopedNoDenormals noDenormals;
+    int blockSize = block.getNumSamples();
+    int noiseLength = noise.getNumSamples() - blockSize;
+    int position = 0;
+    auto start = Clock::now();
+    for (size_t done = 0;done < numSamples;done += (size_t) blockSize)
+    {
+        block.copyFrom(0, 0, noise, 0, position, blockSize);
+        block.copyFrom(1, 0, noise, 1, position, blockSize);
+        work(block);
+        position = (position + blockSize) % noiseLength;
+    }
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    return elapsed.count();
+}
+
+static double nanosPerFrame
+(const juce::AudioBuffer<float>& noise, juce::AudioBuffer<float>& block,
+size_t numSamples, const std::function<void(juce::AudioBuffer<float>&)>& work)
+{
+    double copies = timeBlocks(
+        noise, block, numSamples, [] (juce::AudioBuffer<float>&) { }
+    );
+    double total = timeBlocks(noise, block, numSamples, work);
+    return std::max(0.0, total - copies) / (double) numSamples;
+}
+
+// === Stages =================================================================
+static const std::vector<std::pair<const char*, Stage>> stages {
+    { "gain", [] (PluginProcessor& p, float* l, float* r, size_t n)
+        {
+            p.gainOne.processBlock(l, n);
+            p.gainTwo.processBlock(r, n);
+        }
+    },
+    { "low-cut", [] (PluginProcessor& p, float* l, float* r, size_t n)
+        {
+            p.highPassOne.processBlock(l, n);
+            p.highPassTwo.processBlock(r, n);
+        }
+    },
+    { "peaks", [] (PluginProcessor& p, float* l, float* r, size_t n)
+        {
+            p.peakOne.processBlock(l, n);
+            p.peakThree.processBlock(l, n);
+            p.peakFive.processBlock(l, n);
+            p.peakTwo.processBlock(r, n);
+            p.peakFour.processBlock(r, n);
+            p.peakSix.processBlock(r, n);
+        }
+    },
+    { "high-cut", [] (PluginProcessor& p, float* l, float* r, size_t n)
+        {
+            p.lowPassOne.processBlock(l, n);
+            p.lowPassTwo.processBlock(r, n);
+        }
+    }
+};
+
+// === Benchmark ==============================================================
+static void runConfiguration
+(double sampleRate, int blockSize, bool midSide, int falloff, bool bandsOn)
+{
+    PluginProcessor processor;
+    processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+    configure(processor, midSide, falloff, bandsOn);
+    juce::AudioBuffer<float> noise(2, (int) sampleRate + blockSize);
+    juce::AudioBuffer<float> block(2, blockSize);
+    juce::MidiBuffer midi;
+    fillWithNoise(noise);
+    auto processBlock = [&processor, &midi] (juce::AudioBuffer<float>& b)
+        { processor.processBlock(b, midi); };
+    size_t warmup = (size_t) (sampleRate * secondsOfWarmup);
+    size_t measured = (size_t) (sampleRate * secondsPerMeasurement);
+    timeBlocks(noise, block, warmup, processBlock);
+    double total = nanosPerFrame(noise, block, measured, processBlock);
+    // share of one core needed to keep up with real time
+    double load = total * sampleRate / 1.0e7;
+    std::printf(
+        "%8.0f %6d  %-4s %7d  %-5s %9.2f %7.2f%%",
+        sampleRate, blockSize, midSide ? "M/S" : "L/R", falloff,
+        bandsOn ? "on" : "off", total, load
+    );
+    for (const auto& entry : stages)
+    {
+        const Stage& stage = entry.second;
+        auto runStage = [&processor, &stage] (juce::AudioBuffer<float>& b)
+        {
+            stage(
+                processor, b.getWritePointer(0), b.getWritePointer(1),
+                (size_t) b.getNumSamples()
+            );
+        };
+        std::printf(" %9.2f", nanosPerFrame(noise, block, measured, runStage));
+    }
+    std::printf("\n");
+    std::fflush(stdout);
+}
+
+static void printHeader()
+{
+    std::printf(
+        "%8s %6s  %-4s %7s  %-5s %9s %8s",
+        "rate", "block", "mode", "falloff", "bands", "ns/frame", "load"
+    );
+    for (const auto& entry : stages)
+        std::printf(" %9s", entry.first);
+    std::printf("\n");
+}
+
+int main(int argc, char* argv[])
+{
+    // --quick limits the sweep to a typical session, for regression checks
+    bool quick = argc > 1 && juce::String(argv[1]) == "--quick";
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    printHeader();
+    for (double sampleRate : sampleRates)
+    {
+        if (quick && (int) sampleRate != 48000)
+            continue;
+        for (int blockSize : blockSizes)
+        {
+            if (quick && blockSize != 64 && blockSize != 512)
+                continue;
+            for (bool midSide : { false, true })
+            {
+                // the falloff only matters while the cut filters are on
+                for (int falloff : falloffs)
+                    runConfiguration(
+                        sampleRate, blockSize, midSide, falloff, true
+                    );
+                runConfiguration(sampleRate, blockSize, midSide, 6, false);
+            }
+        }
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,294 @@
+#include <cstdio>
+#include <type_traits>
+#include <vector>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_events/juce_events.h>
+#include "PluginProcessor.h"
+#include "RealtimeGuard.h"
+
+// drives PluginProcessor::processBlock while every parameter is swept
+// through its range, links are toggled and the channel mode and falloffs are
+// flipped back and forth, and fails if the audio thread allocates or locks.
+// changes are made between blocks as the editor or the host's message
+// thread would make them. with --automation they are made on the audio
+// thread as well, the way hosts that deliver automation there would. every
+// parameter is also scheduled to change part way through blocks, so blocks
+// are split and the changes applied on the audio thread. transactions are
+// run too, as reset and link all make them, with many parameters changing
+// in one gesture. the check also fails if any gesture notified the host more
+// than once for a parameter it changed
+
+// === Settings ===============================================================
+static const double sampleRate { 48000 };
+static const int maxBlockSize { 512 };
+// hosts are free to hand over any block size up to the prepared one
+static const std::vector<int> blockSizes { 512, 1, 64, 17, 256, 333, 128 };
+static const int stepsPerParameter { 8 };
+// enough blocks for smoothing, coefficient ramps and fades to all be running
+static const int blocksPerStep { 3 };
+static const int rapidToggleBlocks { 12 };
+// samples between scheduled changes, so several land inside most blocks
+static const int scheduleSpacing { 5 };
+
+// === Session ================================================================
+template <typename SampleType>
+class Session
+{
+public:
+    PluginProcessor processor;
+
+    Session(bool doubleState, bool guardChanges)
+        : buffer(2, maxBlockSize), random(42), guardAutomation(guardChanges),
+        blockIndex(0), samplesProcessed(0)
+    {
+        using Precision = juce::AudioProcessor::ProcessingPrecision;
+        if constexpr (std::is_same_v<SampleType, double>)
+            processor.setProcessingPrecision(Precision::doublePrecision);
+        processor.setDoublePrecisionState(doubleState);
+        processor.setPlayConfigDetails(2, 2, sampleRate, maxBlockSize);
+        processor.prepareToPlay(sampleRate, maxBlockSize);
+    }
+
+    // each change is its own gesture, as a control in the editor makes it
+    void setParameter(juce::AudioProcessorParameter* param, float normalised)
+    {
+        param->beginChangeGesture();
+        if (guardAutomation)
+        {
+            RealtimeGuard::ScopedAudioThread audioThread;
+            param->setValueNotifyingHost(normalised);
+        }
+        else
+        {
+            param->setValueNotifyingHost(normalised);
+        }
+        param->endChangeGesture();
+    }
+
+    void setParameter(const juce::String& id, float normalised)
+    {
+        juce::RangedAudioParameter* param = processor.tree.getParameter(id);
+        if (param != nullptr)
+            setParameter(param, normalised);
+    }
+
+    // the change lands offset samples after everything processed so far
+    void scheduleParameter
+    (juce::AudioProcessorParameter* param, float normalised, int offset)
+    {
+        juce::int64 position = samplesProcessed + offset;
+        if (guardAutomation)
+        {
+            RealtimeGuard::ScopedAudioThread audioThread;
+            processor.scheduleParameterChange(param, normalised, position);
+        }
+        else
+        {
+            processor.scheduleParameterChange(param, normalised, position);
+        }
+    }
+
+    // runs blocks until at least numSamples more have been processed
+    void runFor(int numSamples)
+    {
+        juce::int64 end = samplesProcessed + numSamples;
+        while (samplesProcessed < end)
+            run(1);
+    }
+
+    void run(int numBlocks)
+    {
+        for (int b = 0;b < numBlocks;b++)
+        {
+            int size = blockSizes[(size_t) blockIndex++ % blockSizes.size()];
+            buffer.setSize(2, size, false, false, true);
+            for (int c = 0;c < 2;c++)
+            {
+                SampleType* data = buffer.getWritePointer(c);
+                for (int i = 0;i < size;i++)
+                    data[i] = (SampleType) (random.nextFloat() - 0.5f);
+            }
+            RealtimeGuard::ScopedAudioThread audioThread;
+            processor.processBlock(buffer, midi);
+            samplesProcessed += size;
+        }
+    }
+
+private:
+    juce::AudioBuffer<SampleType> buffer;
+    juce::MidiBuffer midi;
+    juce::Random random;
+    bool guardAutomation;
+    int blockIndex;
+    juce::int64 samplesProcessed;
+};
+
+// === Passes =================================================================
+template <typename SampleType>
+static void sweepParameters(Session<SampleType>& session)
+{
+    PluginProcessor& processor = session.processor;
+    for (juce::AudioProcessorParameter* param : processor.getParameters())
+    {
+        for (int step = 0;step <= stepsPerParameter;step++)
+        {
+            session.setParameter(param, (float) step / stepsPerParameter);
+            session.run(blocksPerStep);
+        }
+        session.setParameter(param, param->getDefaultValue());
+        session.run(blocksPerStep);
+    }
+}
+
+template <typename SampleType>
+static void scheduleChanges(Session<SampleType>& session)
+{
+    PluginProcessor& processor = session.processor;
+    for (juce::AudioProcessorParameter* param : processor.getParameters())
+    {
+        int offset = 0;
+        for (int step = 0;step <= stepsPerParameter;step++)
+        {
+            float value = (float) step / stepsPerParameter;
+            session.scheduleParameter(param, value, offset);
+            offset += scheduleSpacing;
+        }
+        session.scheduleParameter(param, param->getDefaultValue(), offset);
+        // positions only move forward, so the next parameter waits for
+        // every change of this one to land
+        session.runFor(offset + 1);
+        session.run(blocksPerStep);
+    }
+}
+
+template <typename SampleType>
+static void toggleLinks(Session<SampleType>& session)
+{
+    PluginProcessor& p = session.processor;
+    for (const PluginProcessor::FilterLink& link : p.getFilterLinks())
+    {
+        // the processor links the filters as soon as the parameter is on
+        session.setParameter(link.id, 1);
+        session.run(blocksPerStep);
+        std::vector<ParameterBlueprint> parameters;
+        link.leader->getParameters(parameters);
+        for (ParameterBlueprint& blueprint : parameters)
+        {
+            juce::String paramId = link.leader->name + "-"
+                + blueprint.idPostfix;
+            session.setParameter(paramId, 1);
+            session.run(blocksPerStep);
+            session.setParameter(paramId, 0);
+            session.run(blocksPerStep);
+        }
+        session.setParameter(link.id, 0);
+        session.run(blocksPerStep);
+    }
+}
+
+template <typename SampleType>
+static void toggleRapidly(Session<SampleType>& session)
+{
+    // flips faster than the fades take to finish, to reach the paths that
+    // reverse a fade part way through
+    for (juce::String id : {
+        "mode", "hpf1-falloff", "hpf2-shelf-mode", "lpf1-falloff",
+        "lpf2-shelf-mode", "peak1-on", "gain2-on"
+    })
+    {
+        session.setParameter(id, 1);
+        session.run(blocksPerStep);
+        for (int b = 0;b < rapidToggleBlocks;b++)
+        {
+            session.setParameter(id, (float) (b % 2));
+            session.run(1);
+        }
+        session.run(blocksPerStep);
+    }
+}
+
+template <typename SampleType>
+static void runTransactions(Session<SampleType>& session)
+{
+    // transactions are made on the message thread only, so they are never
+    // guarded, but the blocks after them pick every change up together
+    PluginProcessor& processor = session.processor;
+    processor.setAllLinked(true);
+    session.run(blocksPerStep);
+    processor.setAllLinked(false);
+    session.run(blocksPerStep);
+    processor.beginTransaction("Check");
+    for (juce::AudioProcessorParameter* param : processor.getParameters())
+    {
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(param);
+        if (ranged != nullptr)
+            processor.setInTransaction(ranged, 1);
+    }
+    processor.endTransaction();
+    session.run(blocksPerStep);
+    processor.resetAllParams();
+    session.run(blocksPerStep);
+}
+
+// true if nothing allocated or locked and no gesture notified the host more
+// than once for any parameter it changed
+template <typename SampleType>
+static bool runPass(const char* name, bool doubleState, bool guardAutomation)
+{
+    size_t before = RealtimeGuard::getViolationCount();
+    Session<SampleType> session(doubleState, guardAutomation);
+    sweepParameters(session);
+    scheduleChanges(session);
+    toggleLinks(session);
+    toggleRapidly(session);
+    runTransactions(session);
+    size_t found = RealtimeGuard::getViolationCount() - before;
+    const GestureCounter& gestures = session.processor.getGestureCounter();
+    int repeated = gestures.getMostRepeatedInAGesture();
+    bool passed = found == 0 && repeated == 0;
+    std::printf(
+        "%-24s %-4s %zu violations, at most %d notifications per gesture, "
+        "%d repeated\n",
+        name, passed ? "ok" : "FAIL", found, gestures.getMostInAGesture(),
+        repeated
+    );
+    std::fflush(stdout);
+    return passed;
+}
+
+int main(int argc, char* argv[])
+{
+    bool guardAutomation = argc > 1 && juce::String(argv[1]) == "--automation";
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    if (!RealtimeGuard::isInterposingLibc())
+    {
+        std::printf(
+            "malloc and locks can only be interposed on glibc, so only "
+            "operator new and delete are checked\n"
+        );
+    }
+    bool passed = runPass<float>("float", false, guardAutomation);
+    passed = runPass<float>("float with double state", true, guardAutomation)
+        && passed;
+    passed = runPass<double>("double", false, guardAutomation) && passed;
+    size_t sites = RealtimeGuard::getReportedCallSiteCount();
+    if (sites > 0)
+    {
+        std::printf(
+            "%zu call sites allocate or lock on the audio thread\n", sites
+        );
+        return 1;
+    }
+    if (!passed)
+    {
+        std::printf(
+            "a gesture notified the host more than once for a parameter\n"
+        );
+        return 1;
+    }
+    std::printf(
+        "no allocations or locks on the audio thread, and no repeated "
+        "notifications\n"
+    );
+    return 0;
+}
\ No newline at end of file
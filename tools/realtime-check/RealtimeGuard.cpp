@@ -0,0 +1,198 @@
+#include "RealtimeGuard.h"
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <set>
+#include <string>
+#include <juce_core/juce_core.h>
+#if defined(__GLIBC__)
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
+
+// === Raw Allocation =========================================================
+#if defined(__GLIBC__)
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void __libc_free(void*);
+}
+
+using LockFunction = int (*)(pthread_mutex_t*);
+// looked up on first use rather than through a function local static, as
+// the guard on those can itself lock a mutex
+static std::atomic<LockFunction> realLock { nullptr };
+
+static void* allocate(size_t size) { return __libc_malloc(size); }
+static void release(void* pointer) { __libc_free(pointer); }
+
+static int lock(pthread_mutex_t* mutex)
+{
+    LockFunction function = realLock.load();
+    if (function == nullptr)
+    {
+        function = (LockFunction) dlsym(RTLD_NEXT, "pthread_mutex_lock");
+        realLock.store(function);
+    }
+    return function(mutex);
+}
+#else
+static void* allocate(size_t size) { return std::malloc(size); }
+static void release(void* pointer) { std::free(pointer); }
+#endif
+
+// === Audio Thread ===========================================================
+RealtimeGuard::ScopedAudioThread::ScopedAudioThread()
+{
+    onAudioThread = true;
+}
+
+RealtimeGuard::ScopedAudioThread::~ScopedAudioThread()
+{
+    onAudioThread = false;
+}
+
+// === Hooks ==================================================================
+void RealtimeGuard::check(const char* operation)
+{
+    if (!onAudioThread || reporting)
+        return;
+    // reporting allocates, so hooks are ignored until it's done
+    reporting = true;
+    report(operation);
+    reporting = false;
+}
+
+// === Results ================================================================
+size_t RealtimeGuard::getViolationCount()
+{
+    return violations.load();
+}
+
+size_t RealtimeGuard::getReportedCallSiteCount()
+{
+    return callSites.load();
+}
+
+bool RealtimeGuard::isInterposingLibc()
+{
+#if defined(__GLIBC__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// === Private Helper =========================================================
+void RealtimeGuard::report(const char* operation)
+{
+    violations++;
+    // the same call site is hit on every block, so each is only shown once
+    static std::set<std::string> seen;
+    juce::String trace = juce::SystemStats::getStackBacktrace();
+    if (!seen.insert(trace.toStdString()).second)
+        return;
+    callSites++;
+    std::fprintf(
+        stderr, "\n%s on the audio thread:\n%s", operation, trace.toRawUTF8()
+    );
+}
+
+// === Interposed Functions ===================================================
+#if defined(__GLIBC__)
+extern "C"
+{
+    void* malloc(size_t size) noexcept
+    {
+        RealtimeGuard::check("malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        RealtimeGuard::check("calloc");
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size) noexcept
+    {
+        RealtimeGuard::check("realloc");
+        return __libc_realloc(pointer, size);
+    }
+
+    void free(void* pointer) noexcept
+    {
+        if (pointer != nullptr)
+            RealtimeGuard::check("free");
+        __libc_free(pointer);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        RealtimeGuard::check("pthread_mutex_lock");
+        return lock(mutex);
+    }
+}
+#endif
+
+// === Replaced Operators =====================================================
+// these go straight to the raw allocator, so one new is reported only once
+void* operator new(size_t size)
+{
+    RealtimeGuard::check("operator new");
+    void* pointer = allocate(size == 0 ? 1 : size);
+    if (pointer == nullptr)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](size_t size)
+{
+    RealtimeGuard::check("operator new[]");
+    void* pointer = allocate(size == 0 ? 1 : size);
+    if (pointer == nullptr)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    RealtimeGuard::check("operator new");
+    return allocate(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    RealtimeGuard::check("operator new[]");
+    return allocate(size == 0 ? 1 : size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        RealtimeGuard::check("operator delete");
+    release(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        RealtimeGuard::check("operator delete[]");
+    release(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    if (pointer != nullptr)
+        RealtimeGuard::check("operator delete");
+    release(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    if (pointer != nullptr)
+        RealtimeGuard::check("operator delete[]");
+    release(pointer);
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// catches allocations and locks made by the audio thread. operator new and
+// delete are replaced on every platform. on glibc, malloc, free, calloc,
+// realloc and pthread_mutex_lock are interposed as well, which also covers
+// the allocations and locks made inside JUCE and the standard library. any
+// hook hit while the calling thread is inside a ScopedAudioThread counts as
+// a violation, and every distinct call site is reported with a stack trace
+class RealtimeGuard
+{
+public:
+    // === Audio Thread =======================================================
+    // marks the current thread as the audio thread while in scope
+    class ScopedAudioThread
+    {
+    public:
+        ScopedAudioThread();
+        ~ScopedAudioThread();
+    };
+
+    // === Hooks ==============================================================
+    static void check(const char* operation);
+
+    // === Results ============================================================
+    static size_t getViolationCount();
+    static size_t getReportedCallSiteCount();
+    static bool isInterposingLibc();
+
+private:
+    inline static thread_local bool onAudioThread { false };
+    inline static thread_local bool reporting { false };
+    inline static std::atomic<size_t> violations { 0 };
+    inline static std::atomic<size_t> callSites { 0 };
+
+    // === Private Helper =====================================================
+    static void report(const char* operation);
+};
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_events/juce_events.h>
+#include "PluginProcessor.h"
+
+// loads binary states written with parameter layouts other than the current
+// one, as sessions saved by earlier or later releases would be, and fails
+// if a value lands on the wrong parameter, a parameter the state does not
+// mention keeps anything but its default, or data that should be refused
+// changes anything. the states are written here byte by byte rather than
+// through BinaryState, so the format itself is checked as well
+
+// === Settings ===============================================================
+static const juce::uint32 magic { 0x51455053 };
+static const juce::uint32 hashSeed { 2166136261u };
+static const juce::uint32 hashPrime { 16777619u };
+// values are stored in plain units and snapped to each parameter's interval
+static const float tolerance { 0.001f };
+
+// === State Writing ==========================================================
+using Values = std::vector<std::pair<std::string, float>>;
+
+static juce::uint32 hash(juce::uint32 seed, const void* data, size_t size)
+{
+    auto* bytes = static_cast<const juce::uint8*>(data);
+    juce::uint32 result = seed;
+    for (size_t i = 0;i < size;i++)
+    {
+        result ^= bytes[i];
+        result *= hashPrime;
+    }
+    return result;
+}
+
+static void writeChecksum(juce::MemoryBlock& block)
+{
+    juce::uint32 checksum = hash(hashSeed, block.getData(), block.getSize());
+    juce::MemoryOutputStream stream(block, true);
+    stream.writeInt((int) checksum);
+}
+
+// the current format, with an id hash in front of every value
+static juce::MemoryBlock writeState(const Values& values, juce::uint16 version)
+{
+    juce::MemoryBlock block;
+    {
+        juce::MemoryOutputStream stream(block, false);
+        stream.writeInt((int) magic);
+        stream.writeShort((short) version);
+        stream.writeShort((short) values.size());
+        for (const auto& [id, value] : values)
+        {
+            stream.writeInt((int) hash(hashSeed, id.c_str(), id.size()));
+            stream.writeFloat(value);
+        }
+    }
+    writeChecksum(block);
+    return block;
+}
+
+// version 1, which held every value in publish order behind a fingerprint
+// of the ids
+static juce::MemoryBlock writeVersionOne(PluginProcessor& processor)
+{
+    juce::uint32 layout = hashSeed;
+    std::vector<float> values;
+    for (juce::AudioProcessorParameter* param : processor.getParameters())
+    {
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(param);
+        if (ranged == nullptr)
+            continue;
+        std::string id = ranged->getParameterID().toStdString();
+        layout = hash(layout, id.c_str(), id.size() + 1);
+        values.push_back(ranged->convertFrom0to1(ranged->getValue()));
+    }
+    juce::MemoryBlock block;
+    {
+        juce::MemoryOutputStream stream(block, false);
+        stream.writeInt((int) magic);
+        stream.writeShort(1);
+        stream.writeShort((short) values.size());
+        stream.writeInt((int) layout);
+        for (float value : values)
+            stream.writeFloat(value);
+    }
+    writeChecksum(block);
+    return block;
+}
+
+// === Checks =================================================================
+static int failures = 0;
+
+static void expect(bool passed, const char* what)
+{
+    std::printf("%-4s %s\n", passed ? "ok" : "FAIL", what);
+    if (!passed)
+        failures++;
+}
+
+static float getValue(PluginProcessor& processor, const juce::String& id)
+{
+    juce::RangedAudioParameter* param = processor.tree.getParameter(id);
+    return param->convertFrom0to1(param->getValue());
+}
+
+static void setValue
+(PluginProcessor& processor, const juce::String& id, float value)
+{
+    juce::RangedAudioParameter* param = processor.tree.getParameter(id);
+    param->setValueNotifyingHost(param->convertTo0to1(value));
+}
+
+static bool isDefault(PluginProcessor& processor, const juce::String& id)
+{
+    juce::RangedAudioParameter* param = processor.tree.getParameter(id);
+    float value = param->convertFrom0to1(param->getDefaultValue());
+    return std::abs(getValue(processor, id) - value) < tolerance;
+}
+
+static bool hasValue
+(PluginProcessor& processor, const juce::String& id, float value)
+{
+    return std::abs(getValue(processor, id) - value) < tolerance;
+}
+
+static bool load(PluginProcessor& processor, const juce::MemoryBlock& block)
+{
+    return processor.restoreState(block.getData(), (int) block.getSize());
+}
+
+static void checkRoundTrip()
+{
+    PluginProcessor saved;
+    setValue(saved, "peak1-gain", -6);
+    setValue(saved, "hpf2-freq", 120);
+    setValue(saved, "mode", 1);
+    juce::MemoryBlock block;
+    saved.getStateInformation(block);
+    PluginProcessor loaded;
+    bool read = load(loaded, block);
+    expect(
+        read && hasValue(loaded, "peak1-gain", -6)
+            && hasValue(loaded, "hpf2-freq", 120)
+            && hasValue(loaded, "mode", 1),
+        "a saved state loads back"
+    );
+}
+
+static void checkOtherLayout()
+{
+    // reordered, without peak3-gain, and with a parameter that no longer
+    // exists, as a session saved by another release would be
+    Values values {
+        { "lpf1-freq", 8000 },
+        { "removed-param", 3 },
+        { "peak1-gain", 4.5f },
+        { "gain2-gain", -3 }
+    };
+    PluginProcessor processor;
+    setValue(processor, "peak3-gain", 9);
+    bool read = load(processor, writeState(values, 2));
+    expect(read, "a state with another layout is accepted");
+    expect(
+        hasValue(processor, "lpf1-freq", 8000)
+            && hasValue(processor, "peak1-gain", 4.5f)
+            && hasValue(processor, "gain2-gain", -3),
+        "values are matched to parameters by id"
+    );
+    expect(
+        isDefault(processor, "peak3-gain") && isDefault(processor, "mode"),
+        "parameters missing from the state return to their defaults"
+    );
+}
+
+static void checkVersionOne()
+{
+    PluginProcessor saved;
+    setValue(saved, "peak5-q", 2);
+    setValue(saved, "gain1-gain", 6);
+    juce::MemoryBlock block = writeVersionOne(saved);
+    PluginProcessor loaded;
+    bool read = load(loaded, block);
+    expect(
+        read && hasValue(loaded, "peak5-q", 2)
+            && hasValue(loaded, "gain1-gain", 6),
+        "a version 1 state is migrated"
+    );
+}
+
+static void checkRefused()
+{
+    PluginProcessor processor;
+    setValue(processor, "peak1-gain", -6);
+    juce::MemoryBlock newer = writeState({ { "peak1-gain", 3 } }, 3);
+    juce::MemoryBlock corrupt = writeState({ { "peak1-gain", 3 } }, 2);
+    static_cast<char*>(corrupt.getData())[10] ^= 1;
+    bool refused = !load(processor, newer) && !load(processor, corrupt);
+    expect(
+        refused && hasValue(processor, "peak1-gain", -6),
+        "newer and corrupt states are refused without changing anything"
+    );
+}
+
+// === Main ===================================================================
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    checkRoundTrip();
+    checkOtherLayout();
+    checkVersionOne();
+    checkRefused();
+    if (failures > 0)
+    {
+        std::printf("%d state checks failed\n", failures);
+        return 1;
+    }
+    std::printf("every state loaded as expected\n");
+    return 0;
+}
\ No newline at end of file